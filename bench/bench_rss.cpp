@@ -0,0 +1,29 @@
+#include "bench_rss.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+long GetPeakRssKb()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (long)(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#elif defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (long)(usage.ru_maxrss / 1024); // bytes on macOS
+#elif defined(__unix__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (long)usage.ru_maxrss; // kilobytes on Linux
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// Peak resident set size of the current process in kilobytes, 0 if unknown.
+// Lives in its own file so windows.h never meets raylib.h in one translation unit.
+long GetPeakRssKb();
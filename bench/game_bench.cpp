@@ -0,0 +1,689 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <thread>
+#include "raylib.h"
+#include "globals.h"
+#include "game.h"
+#include "memtrack.h"
+#include "tilemap.h"
+#include "flowfield.h"
+#include "agents.h"
+#include "scheduler.h"
+#include "frame.h"
+#include "bench_rss.h"
+
+// game_bench runs scripted stress scenes in a hidden window for a fixed number
+// of ticks and prints the results as JSON.
+//
+// Usage:
+//   game_bench [--ticks N] [--balls N] [--agents N] [--scenario NAME] [--out FILE]
+//              [--baseline FILE] [--threshold FRACTION] [--memory-out FILE]
+//
+// With --baseline the results are compared against a previous JSON report and
+// the process exits with 1 if any scenario regressed by more than the threshold.
+// A baseline is produced by running once with --out. --memory-out writes the
+// per tag memory report after all scenarios ran.
+
+struct BenchConfig
+{
+    int ticks = 2000;
+    int balls = 5000;
+    int agents = 10000;
+    std::string scenario;
+    std::string outPath;
+    std::string baselinePath;
+    std::string memoryOutPath;
+    float threshold = 0.10f;
+};
+
+struct BenchResult
+{
+    std::string name;
+    double ticksPerSecond = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double allocsPerTick = 0.0;
+    long peakRssKb = 0;
+};
+
+// A scenario sets itself up once, then Tick is timed for every iteration
+class Scenario
+{
+public:
+    virtual ~Scenario() {}
+    virtual const char* Name() const = 0;
+    virtual void Tick(float dt) = 0;
+};
+
+static const float tickDt = 1.0f / 144.0f;
+
+// N balls bouncing around the game screen, updated and drawn every tick
+class BallsScenario : public Scenario
+{
+public:
+    BallsScenario(int count)
+    {
+        target = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
+        SetRandomSeed(1234);
+        balls.resize(count);
+        for (Ball& ball : balls) {
+            ball.x = (float)GetRandomValue(0, gameScreenWidth);
+            ball.y = (float)GetRandomValue(0, gameScreenHeight);
+            ball.vx = (float)GetRandomValue(-300, 300);
+            ball.vy = (float)GetRandomValue(-300, 300);
+            ball.color = Color{(unsigned char)GetRandomValue(50, 255), (unsigned char)GetRandomValue(50, 255), (unsigned char)GetRandomValue(50, 255), 255};
+        }
+    }
+
+    ~BallsScenario()
+    {
+        UnloadRenderTexture(target);
+    }
+
+    const char* Name() const override { return "balls"; }
+
+    void Tick(float dt) override
+    {
+        for (Ball& ball : balls) {
+            ball.x += ball.vx * dt;
+            ball.y += ball.vy * dt;
+            if (ball.x < 0 || ball.x > gameScreenWidth) ball.vx = -ball.vx;
+            if (ball.y < 0 || ball.y > gameScreenHeight) ball.vy = -ball.vy;
+        }
+
+        BeginDrawing();
+        BeginTextureMode(target);
+        ClearBackground(GRAY);
+        for (const Ball& ball : balls) {
+            DrawCircle((int)ball.x, (int)ball.y, 8, ball.color);
+        }
+        EndTextureMode();
+        FrameEnd(nullptr);
+    }
+
+private:
+    struct Ball
+    {
+        float x, y;
+        float vx, vy;
+        Color color;
+    };
+
+    std::vector<Ball> balls;
+    RenderTexture2D target;
+};
+
+// The real Game object sitting in its main menu, so this exercises the menu
+// update and draw paths exactly as the game runs them
+class MenusScenario : public Scenario
+{
+public:
+    MenusScenario()
+    {
+        game = new Game(gameScreenWidth, gameScreenHeight);
+    }
+
+    ~MenusScenario()
+    {
+        delete game;
+    }
+
+    const char* Name() const override { return "menus"; }
+
+    void Tick(float dt) override
+    {
+        game->Update(dt);
+        game->Draw();
+    }
+
+private:
+    Game* game;
+};
+
+// Bursts of short lived particles from a preallocated pool
+class ParticlesScenario : public Scenario
+{
+public:
+    ParticlesScenario()
+    {
+        MemTagScope memTag(MEMTAG_PARTICLES);
+        target = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
+        MemTrackGpu(MEMTAG_PARTICLES, MemRenderTextureBytes(target));
+        SetRandomSeed(5678);
+        particles.resize(maxParticles);
+    }
+
+    ~ParticlesScenario()
+    {
+        MemTrackGpu(MEMTAG_PARTICLES, -MemRenderTextureBytes(target));
+        UnloadRenderTexture(target);
+    }
+
+    const char* Name() const override { return "particles"; }
+
+    void Tick(float dt) override
+    {
+        if (tick % burstInterval == 0) {
+            float originX = (float)GetRandomValue(100, gameScreenWidth - 100);
+            float originY = (float)GetRandomValue(100, gameScreenHeight - 100);
+            for (int i = 0; i < burstSize; i++) {
+                Particle& p = particles[nextParticle];
+                nextParticle = (nextParticle + 1) % maxParticles;
+                p.x = originX;
+                p.y = originY;
+                p.vx = (float)GetRandomValue(-400, 400);
+                p.vy = (float)GetRandomValue(-400, 100);
+                p.life = 1.0f + GetRandomValue(0, 100) / 100.0f;
+            }
+        }
+        tick++;
+
+        for (Particle& p : particles) {
+            if (p.life <= 0.0f) continue;
+            p.vy += 600.0f * dt;
+            p.x += p.vx * dt;
+            p.y += p.vy * dt;
+            p.life -= dt;
+        }
+
+        BeginDrawing();
+        BeginTextureMode(target);
+        ClearBackground(GRAY);
+        for (const Particle& p : particles) {
+            if (p.life <= 0.0f) continue;
+            unsigned char alpha = (unsigned char)(MIN(p.life, 1.0f) * 255);
+            DrawRectangle((int)p.x, (int)p.y, 3, 3, Color{255, 200, 60, alpha});
+        }
+        EndTextureMode();
+        FrameEnd(nullptr);
+    }
+
+private:
+    struct Particle
+    {
+        float x = 0, y = 0;
+        float vx = 0, vy = 0;
+        float life = 0;
+    };
+
+    static const int maxParticles = 20000;
+    static const int burstSize = 1000;
+    static const int burstInterval = 20;
+
+    std::vector<Particle> particles;
+    int nextParticle = 0;
+    int tick = 0;
+    RenderTexture2D target;
+};
+
+// Retriggers the action sound on many voices every tick
+class AudioScenario : public Scenario
+{
+public:
+    AudioScenario()
+    {
+        sound = LoadSound("data/action.mp3");
+        loaded = (sound.stream.buffer != NULL);
+        if (!loaded) {
+            TraceLog(LOG_WARNING, "BENCH: Failed to load data/action.mp3, audio scenario only measures frame overhead");
+            return;
+        }
+        for (int i = 0; i < voiceCount; i++) {
+            voices[i] = LoadSoundAlias(sound);
+        }
+    }
+
+    ~AudioScenario()
+    {
+        if (!loaded) return;
+        for (int i = 0; i < voiceCount; i++) {
+            UnloadSoundAlias(voices[i]);
+        }
+        UnloadSound(sound);
+    }
+
+    const char* Name() const override { return "audio"; }
+
+    void Tick(float) override
+    {
+        for (int i = 0; loaded && i < triggersPerTick; i++) {
+            Sound& voice = voices[nextVoice];
+            nextVoice = (nextVoice + 1) % voiceCount;
+            StopSound(voice);
+            PlaySound(voice);
+        }
+
+        BeginDrawing();
+        FrameEnd(nullptr);
+    }
+
+private:
+    static const int voiceCount = 16;
+    static const int triggersPerTick = 8;
+
+    Sound sound;
+    Sound voices[voiceCount];
+    bool loaded = false;
+    int nextVoice = 0;
+};
+
+// Agents following a flow field towards a target that circles the level, so
+// the field is rebuilt on the worker every few ticks. Only the simulation is
+// timed, drawing the agents is covered by the other scenes.
+class FlowFieldScenario : public Scenario
+{
+public:
+    FlowFieldScenario(int count)
+    {
+        SetRandomSeed(4321);
+        if (!tileMap.Load("data/level.map")) {
+            TraceLog(LOG_WARNING, "BENCH: Failed to load data/level.map, flow field scenarios do nothing");
+        }
+        field.Init(tileMap);
+        field.SetTarget(TargetAt(0));
+        WaitForField();
+        swarm.Spawn(count, field);
+    }
+
+    const char* Name() const override { return "flowfield"; }
+
+    void Tick(float dt) override
+    {
+        field.SetTarget(TargetAt(tick++));
+        field.Update();
+        swarm.Update(dt, field);
+    }
+
+protected:
+    Vector2 TargetAt(int tick) const
+    {
+        float worldW = (float)(tileMap.GetWidth() * tileMap.GetTileSize());
+        float worldH = (float)(tileMap.GetHeight() * tileMap.GetTileSize());
+        float angle = tick * 0.01f;
+        return {worldW * (0.5f + 0.35f * cosf(angle)), worldH * (0.5f + 0.35f * sinf(angle))};
+    }
+
+    void WaitForField()
+    {
+        if (field.GetColumns() == 0) return;
+        while (!field.Update()) {
+            std::this_thread::yield();
+        }
+    }
+
+    TileMap tileMap;
+    FlowField field;
+    AgentSwarm swarm;
+    int tick = 0;
+};
+
+// Worst case for the field itself: the target jumps across the level every
+// tick and the tick waits for the worker to finish the new field
+class FlowFieldRebuildScenario : public FlowFieldScenario
+{
+public:
+    FlowFieldRebuildScenario() : FlowFieldScenario(0) {}
+
+    const char* Name() const override { return "flowfield_rebuild"; }
+
+    void Tick(float) override
+    {
+        tick++;
+        field.SetTarget(TargetAt((tick % 2) * 314));
+        WaitForField();
+    }
+};
+
+// The flow field and agents as scheduler systems, with the agents split into
+// swarms that only read the field, so they run concurrently unless serial
+class SystemsScenario : public FlowFieldScenario
+{
+public:
+    SystemsScenario(int count, bool serial) : FlowFieldScenario(0), serial(serial)
+    {
+        static const char* swarmNames[swarmCount] = {"agents_0", "agents_1", "agents_2", "agents_3"};
+        const ResourceMask fieldResource = 1 << 0;
+
+        scheduler.SetSerial(serial);
+        scheduler.AddSystem("flow_field", 0, fieldResource, false, [this] {
+            field.SetTarget(TargetAt(tick++));
+            field.Update();
+        });
+        for (int i = 0; i < swarmCount; i++) {
+            swarms[i].Spawn(count / swarmCount, field);
+            AgentSwarm* swarm = &swarms[i];
+            scheduler.AddSystem(swarmNames[i], fieldResource, 1 << (i + 1), false, [this, swarm] {
+                swarm->Update(tickDt, field);
+            });
+        }
+    }
+
+    const char* Name() const override { return serial ? "systems_serial" : "systems"; }
+
+    void Tick(float dt) override
+    {
+        tickDt = dt;
+        scheduler.Run();
+    }
+
+private:
+    static const int swarmCount = 4;
+    bool serial;
+    float tickDt = 0.0f;
+    AgentSwarm swarms[swarmCount];
+    SystemScheduler scheduler;
+};
+
+static double Percentile(std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty()) return 0.0;
+    size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[MIN(index, sorted.size() - 1)];
+}
+
+static BenchResult RunScenario(Scenario& scenario, int ticks)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Warm up so first-use costs (shader compile, batch growth) stay out of the numbers
+    for (int i = 0; i < 10; i++) {
+        scenario.Tick(tickDt);
+    }
+
+    std::vector<double> tickMs;
+    tickMs.reserve(ticks);
+
+    unsigned long long allocsBefore = MemTrackTotalAllocations();
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < ticks; i++) {
+        Clock::time_point tickStart = Clock::now();
+        scenario.Tick(tickDt);
+        tickMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - tickStart).count());
+    }
+    double totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    // The timing vector was reserved up front so it does not count here
+    unsigned long long allocs = MemTrackTotalAllocations() - allocsBefore;
+
+    std::sort(tickMs.begin(), tickMs.end());
+
+    BenchResult result;
+    result.name = scenario.Name();
+    result.ticksPerSecond = totalSeconds > 0.0 ? ticks / totalSeconds : 0.0;
+    result.p50Ms = Percentile(tickMs, 0.50);
+    result.p99Ms = Percentile(tickMs, 0.99);
+    result.allocsPerTick = (double)allocs / ticks;
+    result.peakRssKb = GetPeakRssKb();
+    return result;
+}
+
+static std::string ResultsToJson(const std::vector<BenchResult>& results, int ticks)
+{
+    std::string json = "{\n  \"ticks\": " + std::to_string(ticks) + ",\n  \"scenarios\": [\n";
+    char line[512];
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        snprintf(line, sizeof(line),
+            "    {\"name\": \"%s\", \"ticks_per_sec\": %.2f, \"p50_ms\": %.4f, \"p99_ms\": %.4f, "
+            "\"allocs_per_tick\": %.3f, \"peak_rss_kb\": %ld}%s\n",
+            r.name.c_str(), r.ticksPerSecond, r.p50Ms, r.p99Ms, r.allocsPerTick, r.peakRssKb,
+            (i + 1 < results.size()) ? "," : "");
+        json += line;
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+// Reads "key": number from a flat JSON object, returns false if missing
+static bool FindJsonNumber(const std::string& object, const char* key, double& value)
+{
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t pos = object.find(pattern);
+    if (pos == std::string::npos) return false;
+    value = strtod(object.c_str() + pos + pattern.size(), nullptr);
+    return true;
+}
+
+// Parses the reports written by ResultsToJson, one scenario object per line
+static std::vector<BenchResult> ParseResults(const std::string& json)
+{
+    std::vector<BenchResult> results;
+    size_t pos = 0;
+    while ((pos = json.find("{\"name\": \"", pos)) != std::string::npos) {
+        size_t end = json.find('}', pos);
+        if (end == std::string::npos) break;
+        std::string object = json.substr(pos, end - pos);
+        size_t nameStart = strlen("{\"name\": \"");
+        size_t nameEnd = object.find('"', nameStart);
+
+        BenchResult r;
+        r.name = object.substr(nameStart, nameEnd - nameStart);
+        double rss = 0.0;
+        FindJsonNumber(object, "ticks_per_sec", r.ticksPerSecond);
+        FindJsonNumber(object, "p50_ms", r.p50Ms);
+        FindJsonNumber(object, "p99_ms", r.p99Ms);
+        FindJsonNumber(object, "allocs_per_tick", r.allocsPerTick);
+        FindJsonNumber(object, "peak_rss_kb", rss);
+        r.peakRssKb = (long)rss;
+        results.push_back(r);
+        pos = end;
+    }
+    return results;
+}
+
+// Prints one metric comparison and returns true if it regressed.
+// higherIsBetter flips the direction, e.g. for ticks per second. Changes smaller
+// than minDelta are noise, e.g. a p99 going from 0.0003 to 0.0004 ms.
+static bool CompareMetric(const std::string& scenario, const char* metric, double baseline, double current, bool higherIsBetter, float threshold, double minDelta)
+{
+    double change = baseline != 0.0 ? (current - baseline) / baseline : (current > 0.0 ? 1.0 : 0.0);
+    bool regressed = higherIsBetter ? (change < -threshold) : (change > threshold);
+    if (fabs(current - baseline) < minDelta) regressed = false;
+    printf("%-10s %-16s %12.4f -> %12.4f  %+7.1f%%%s\n", scenario.c_str(), metric, baseline, current, change * 100.0,
+        regressed ? "  REGRESSION" : "");
+    return regressed;
+}
+
+static bool CompareWithBaseline(const std::vector<BenchResult>& results, const std::string& baselinePath, float threshold)
+{
+    char* text = LoadFileText(baselinePath.c_str());
+    if (text == NULL) {
+        TraceLog(LOG_ERROR, "BENCH: Failed to load baseline file: %s", baselinePath.c_str());
+        return false;
+    }
+    std::vector<BenchResult> baseline = ParseResults(text);
+    UnloadFileText(text);
+
+    printf("\nComparison against %s (threshold %.0f%%)\n", baselinePath.c_str(), threshold * 100.0f);
+    bool regressed = false;
+    for (const BenchResult& current : results) {
+        const BenchResult* base = nullptr;
+        for (const BenchResult& b : baseline) {
+            if (b.name == current.name) base = &b;
+        }
+        if (base == nullptr) {
+            printf("%-10s not in baseline, skipped\n", current.name.c_str());
+            continue;
+        }
+        regressed |= CompareMetric(current.name, "ticks_per_sec", base->ticksPerSecond, current.ticksPerSecond, true, threshold, 0.0);
+        regressed |= CompareMetric(current.name, "p50_ms", base->p50Ms, current.p50Ms, false, threshold, 0.01);
+        regressed |= CompareMetric(current.name, "p99_ms", base->p99Ms, current.p99Ms, false, threshold, 0.01);
+        regressed |= CompareMetric(current.name, "allocs_per_tick", base->allocsPerTick, current.allocsPerTick, false, threshold, 0.5);
+        regressed |= CompareMetric(current.name, "peak_rss_kb", (double)base->peakRssKb, (double)current.peakRssKb, false, threshold, 1024.0);
+    }
+    return !regressed;
+}
+
+static const char* scenarioNames[] = {"balls", "menus", "particles", "audio", "flowfield", "flowfield_rebuild", "systems", "systems_serial"};
+
+static BenchResult RunScenarioInProcess(const char* name, const BenchConfig& config)
+{
+    Scenario* scenario = nullptr;
+    if (strcmp(name, "balls") == 0) scenario = new BallsScenario(config.balls);
+    else if (strcmp(name, "menus") == 0) scenario = new MenusScenario();
+    else if (strcmp(name, "particles") == 0) scenario = new ParticlesScenario();
+    else if (strcmp(name, "audio") == 0) scenario = new AudioScenario();
+    else if (strcmp(name, "flowfield") == 0) scenario = new FlowFieldScenario(config.agents);
+    else if (strcmp(name, "flowfield_rebuild") == 0) scenario = new FlowFieldRebuildScenario();
+    else if (strcmp(name, "systems") == 0) scenario = new SystemsScenario(config.agents, false);
+    else scenario = new SystemsScenario(config.agents, true);
+
+    BenchResult result = RunScenario(*scenario, config.ticks);
+    delete scenario;
+    return result;
+}
+
+// "memory.json" becomes "memory.balls.json"
+static std::string ScenarioPath(const std::string& path, const char* name)
+{
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return path + "." + name;
+    }
+    return path.substr(0, dot) + "." + name + path.substr(dot);
+}
+
+// Runs one scenario in a child process of this executable. Peak RSS only ever
+// grows within a process, so scenes sharing one would all report the highest
+// peak of any scene before them.
+static bool RunScenarioProcess(const char* executable, const char* name, const BenchConfig& config, BenchResult& result)
+{
+    std::string resultPath = std::string("game_bench_") + name + ".tmp.json";
+    std::string command = std::string("\"") + executable + "\" --scenario " + name +
+        " --ticks " + std::to_string(config.ticks) +
+        " --balls " + std::to_string(config.balls) +
+        " --agents " + std::to_string(config.agents) +
+        " --out \"" + resultPath + "\"";
+    if (!config.memoryOutPath.empty()) {
+        command += " --memory-out \"" + ScenarioPath(config.memoryOutPath, name) + "\"";
+    }
+#if defined(_WIN32)
+    // cmd strips the outer quotes, keeping the quoted executable path intact
+    command = "\"" + command + " > NUL\"";
+#else
+    command += " > /dev/null";
+#endif
+
+    int status = system(command.c_str());
+    std::vector<BenchResult> parsed;
+    char* text = LoadFileText(resultPath.c_str());
+    if (text != NULL) {
+        parsed = ParseResults(text);
+        UnloadFileText(text);
+        remove(resultPath.c_str());
+    }
+    if (status != 0 || parsed.size() != 1) {
+        fprintf(stderr, "Scenario %s failed (exit status %d)\n", name, status);
+        return false;
+    }
+    result = parsed[0];
+    return true;
+}
+
+static bool ParseArgs(int argc, char** argv, BenchConfig& config)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--ticks" && hasValue) {
+            int ticks = atoi(argv[++i]);
+            config.ticks = MAX(1, ticks);
+        }
+        else if (arg == "--balls" && hasValue) {
+            int balls = atoi(argv[++i]);
+            config.balls = MAX(1, balls);
+        }
+        else if (arg == "--agents" && hasValue) {
+            int agents = atoi(argv[++i]);
+            config.agents = MAX(1, agents);
+        }
+        else if (arg == "--scenario" && hasValue) {
+            config.scenario = argv[++i];
+        }
+        else if (arg == "--out" && hasValue) {
+            config.outPath = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            config.baselinePath = argv[++i];
+        }
+        else if (arg == "--memory-out" && hasValue) {
+            config.memoryOutPath = argv[++i];
+        }
+        else if (arg == "--threshold" && hasValue) {
+            config.threshold = (float)atof(argv[++i]);
+        }
+        else {
+            fprintf(stderr, "Usage: game_bench [--ticks N] [--balls N] [--agents N] "
+                "[--scenario balls|menus|particles|audio|flowfield|flowfield_rebuild|systems|systems_serial] "
+                "[--out FILE] [--baseline FILE] [--threshold FRACTION] [--memory-out FILE]\n"
+                "Without --scenario every scene runs in its own process, --memory-out then writes one FILE per scene "
+                "with the scene name before the extension.\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig config;
+    if (!ParseArgs(argc, argv, config)) {
+        return 2;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    std::vector<BenchResult> results;
+    if (config.scenario.empty()) {
+        for (const char* name : scenarioNames) {
+            BenchResult result;
+            if (!RunScenarioProcess(argv[0], name, config, result)) {
+                return 2;
+            }
+            results.push_back(result);
+        }
+    } else {
+        for (const char* name : scenarioNames) {
+            if (config.scenario != name) continue;
+
+            // Headless as far as raylib allows: hidden window, no vsync, no frame limiter
+            SetConfigFlags(FLAG_WINDOW_HIDDEN);
+            InitWindow(gameScreenWidth, gameScreenHeight, "game_bench");
+            InitAudioDevice();
+            FrameSetTargetFps(0);
+            results.push_back(RunScenarioInProcess(name, config));
+            CloseAudioDevice();
+            CloseWindow();
+        }
+    }
+
+    if (results.empty()) {
+        fprintf(stderr, "Unknown scenario: %s\n", config.scenario.c_str());
+        return 2;
+    }
+
+    std::string json = ResultsToJson(results, config.ticks);
+    printf("%s", json.c_str());
+    if (!config.outPath.empty()) {
+        if (!SaveFileData(config.outPath.c_str(), (void*)json.c_str(), (int)json.size())) {
+            fprintf(stderr, "Failed to write %s\n", config.outPath.c_str());
+            return 2;
+        }
+    }
+
+    // With several scenes each process wrote its own report
+    if (!config.scenario.empty() && !config.memoryOutPath.empty() && !MemTrackWriteJson(config.memoryOutPath.c_str())) {
+        fprintf(stderr, "Failed to write %s\n", config.memoryOutPath.c_str());
+        return 2;
+    }
+
+    if (!config.baselinePath.empty()) {
+        return CompareWithBaseline(results, config.baselinePath, config.threshold) ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <vector>
+#include <cmath>
+#include "raylib.h"
+#include "agents.h"
+#include "memtrack.h"
+
+void AgentSwarm::Spawn(int count, const FlowField& field)
+{
+    MemTagScope memTag(MEMTAG_ENTITIES);
+    Clear();
+    int columns = field.GetColumns();
+    int rows = field.GetRows();
+    if (columns == 0 || rows == 0) return;
+
+    posX.reserve(count);
+    posY.reserve(count);
+    velX.assign(count, 0.0f);
+    velY.assign(count, 0.0f);
+    speedScale.reserve(count);
+    colors.reserve(count);
+
+    float cellSize = (float)field.GetCellSize();
+    int attempts = 0;
+    while ((int)posX.size() < count && attempts < count * 20) {
+        attempts++;
+        float x = (GetRandomValue(0, columns - 1) + GetRandomValue(10, 90) / 100.0f) * cellSize;
+        float y = (GetRandomValue(0, rows - 1) + GetRandomValue(10, 90) / 100.0f) * cellSize;
+        if (field.IsBlocked(x, y)) continue;
+        posX.push_back(x);
+        posY.push_back(y);
+        speedScale.push_back(GetRandomValue(70, 130) / 100.0f);
+        unsigned char shade = (unsigned char)GetRandomValue(160, 230);
+        colors.push_back(Color{shade, (unsigned char)(shade / 3), (unsigned char)(shade / 2), 255});
+    }
+    velX.resize(posX.size());
+    velY.resize(posX.size());
+}
+
+void AgentSwarm::Clear()
+{
+    posX.clear();
+    posY.clear();
+    velX.clear();
+    velY.clear();
+    speedScale.clear();
+    colors.clear();
+}
+
+void AgentSwarm::Update(float dt, const FlowField& field)
+{
+    // Exponential smoothing like the camera, frame rate independent
+    float t = 1.0f - expf(-turnRate * dt);
+    int count = (int)posX.size();
+    for (int i = 0; i < count; i++) {
+        Vector2 direction = field.GetDirection(posX[i], posY[i]);
+        float agentSpeed = speed * speedScale[i];
+        velX[i] += (direction.x * agentSpeed - velX[i]) * t;
+        velY[i] += (direction.y * agentSpeed - velY[i]) * t;
+
+        // Move each axis separately so agents slide along walls instead of sticking
+        float x = posX[i] + velX[i] * dt;
+        if (!field.IsBlocked(x, posY[i])) {
+            posX[i] = x;
+        } else {
+            velX[i] = 0.0f;
+        }
+        float y = posY[i] + velY[i] * dt;
+        if (!field.IsBlocked(posX[i], y)) {
+            posY[i] = y;
+        } else {
+            velY[i] = 0.0f;
+        }
+    }
+}
+
+int AgentSwarm::Draw(RenderQueue& queue, Rectangle view, const Sprite& sprite) const
+{
+    float half = size * 0.5f;
+    float right = view.x + view.width;
+    float bottom = view.y + view.height;
+    int count = (int)posX.size();
+    int drawn = 0;
+    for (int i = 0; i < count; i++) {
+        float x = posX[i];
+        float y = posY[i];
+        if (x + half < view.x || x - half > right || y + half < view.y || y - half > bottom) continue;
+        drawn++;
+        if (sprite.IsValid()) {
+            queue.AddSprite(LAYER_PROPS, sprite, {x - half, y - half, size, size}, colors[i]);
+        } else {
+            queue.AddRectangle(LAYER_PROPS, {x - half, y - half, size, size}, colors[i]);
+        }
+    }
+    return drawn;
+}
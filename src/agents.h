@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+#include "flowfield.h"
+#include "renderqueue.h"
+#include "spriteatlas.h"
+
+// Crowd of agents steered by a shared flow field. Positions and velocities
+// are stored as separate arrays so the per tick update streams through
+// memory without touching colors or other cold data. Agents move every tick,
+// so drawing tests each position against the view instead of keeping them
+// in a grid, the scan only streams the position arrays.
+class AgentSwarm
+{
+public:
+    // Places count agents on random walkable cells of field
+    void Spawn(int count, const FlowField& field);
+    void Clear();
+    // Steers every agent along field and moves it, sliding along blocked cells
+    void Update(float dt, const FlowField& field);
+    // Draws sprite tinted per agent, or squares when the sprite isn't loaded,
+    // returns the number of agents drawn
+    int Draw(RenderQueue& queue, Rectangle view, const Sprite& sprite) const;
+
+    int GetCount() const { return (int)posX.size(); }
+
+    float speed = 120.0f;       // World units per second
+    float turnRate = 6.0f;      // How quickly velocity follows the field, higher is snappier
+    float size = 6.0f;
+
+private:
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> speedScale;      // Per agent variation so crowds spread out
+    std::vector<Color> colors;
+};
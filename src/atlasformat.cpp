@@ -0,0 +1,141 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "atlasformat.h"
+
+static const char atlasMagic[4] = {'A', 'T', 'L', 'S'};
+static const int atlasVersion = 1;
+
+const char* atlasWhiteSprite = "__white";
+
+static bool ReadWholeFile(const char* path, std::vector<unsigned char>& bytes)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    bytes.resize(size > 0 ? size : 0);
+    size_t read = bytes.empty() ? 0 : fread(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+    return read == bytes.size();
+}
+
+static void PutU16(std::vector<unsigned char>& out, int value)
+{
+    out.push_back((unsigned char)(value & 0xFF));
+    out.push_back((unsigned char)((value >> 8) & 0xFF));
+}
+
+static void PutName(std::vector<unsigned char>& out, const std::string& name)
+{
+    out.push_back((unsigned char)name.size());
+    out.insert(out.end(), name.begin(), name.end());
+}
+
+// Bounds checked reader over the file contents
+struct ByteReader
+{
+    const std::vector<unsigned char>& bytes;
+    size_t offset;
+    bool ok;
+
+    int U16()
+    {
+        if (offset + 2 > bytes.size()) { ok = false; return 0; }
+        int value = bytes[offset] | (bytes[offset + 1] << 8);
+        offset += 2;
+        return value;
+    }
+
+    std::string Name()
+    {
+        if (offset + 1 > bytes.size()) { ok = false; return std::string(); }
+        size_t length = bytes[offset++];
+        if (offset + length > bytes.size()) { ok = false; return std::string(); }
+        std::string name(bytes.begin() + offset, bytes.begin() + offset + length);
+        offset += length;
+        return name;
+    }
+};
+
+bool ReadAtlasIndex(const char* path, AtlasIndex& index, std::string& error)
+{
+    std::vector<unsigned char> bytes;
+    if (!ReadWholeFile(path, bytes)) {
+        error = std::string("cannot read ") + path;
+        return false;
+    }
+    if (bytes.size() < 10 || memcmp(bytes.data(), atlasMagic, 4) != 0) {
+        error = std::string(path) + " is not a sprite atlas";
+        return false;
+    }
+
+    ByteReader reader = {bytes, 4, true};
+    if (reader.U16() != atlasVersion) {
+        error = std::string(path) + " has an unsupported version";
+        return false;
+    }
+
+    index = AtlasIndex();
+    int pageCount = reader.U16();
+    int spriteCount = reader.U16();
+    for (int i = 0; i < pageCount && reader.ok; i++) {
+        index.pages.push_back(reader.Name());
+    }
+    index.sprites.reserve(spriteCount);
+    for (int i = 0; i < spriteCount && reader.ok; i++) {
+        AtlasSpriteEntry sprite;
+        sprite.name = reader.Name();
+        sprite.page = reader.U16();
+        sprite.x = reader.U16();
+        sprite.y = reader.U16();
+        sprite.width = reader.U16();
+        sprite.height = reader.U16();
+        if (sprite.page >= pageCount) reader.ok = false;
+        index.sprites.push_back(sprite);
+    }
+
+    if (!reader.ok) {
+        index = AtlasIndex();
+        error = std::string(path) + " is truncated or corrupt";
+        return false;
+    }
+    return true;
+}
+
+bool WriteAtlasIndex(const char* path, AtlasIndex& index, std::string& error)
+{
+    std::sort(index.sprites.begin(), index.sprites.end(),
+        [](const AtlasSpriteEntry& a, const AtlasSpriteEntry& b) { return a.name < b.name; });
+
+    std::vector<unsigned char> out(atlasMagic, atlasMagic + 4);
+    PutU16(out, atlasVersion);
+    PutU16(out, (int)index.pages.size());
+    PutU16(out, (int)index.sprites.size());
+    for (const std::string& page : index.pages) {
+        PutName(out, page);
+    }
+    for (const AtlasSpriteEntry& sprite : index.sprites) {
+        PutName(out, sprite.name);
+        PutU16(out, sprite.page);
+        PutU16(out, sprite.x);
+        PutU16(out, sprite.y);
+        PutU16(out, sprite.width);
+        PutU16(out, sprite.height);
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        error = std::string("cannot write ") + path;
+        return false;
+    }
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    fclose(file);
+    if (!ok) {
+        error = std::string("failed writing ") + path;
+    }
+    return ok;
+}
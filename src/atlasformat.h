@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Sprite atlas index and its on-disk format. Kept free of raylib so the
+// atlas_pack build tool can use it without a window or GPU.
+//
+// Binary format (.atlas), little endian:
+//   char[4]  magic "ATLS"
+//   uint16   version (1)
+//   uint16   page count
+//   uint16   sprite count
+//   per page:   uint8 name length, name bytes (image file next to the index)
+//   per sprite: uint8 name length, name bytes, uint16 page, uint16 x, y, width, height
+// Sprites are stored sorted by name so they can be looked up with a binary search.
+struct AtlasSpriteEntry
+{
+    std::string name;
+    int page = 0;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+struct AtlasIndex
+{
+    std::vector<std::string> pages;
+    std::vector<AtlasSpriteEntry> sprites;
+};
+
+// Sprite name the packer reserves for a small opaque white region, used to draw shapes from the atlas
+extern const char* atlasWhiteSprite;
+
+bool ReadAtlasIndex(const char* path, AtlasIndex& index, std::string& error);
+// Sorts the sprites by name before writing
+bool WriteAtlasIndex(const char* path, AtlasIndex& index, std::string& error);
@@ -0,0 +1,119 @@
+#include <string>
+#include <vector>
+#include "raylib.h"
+#include "filewatcher.h"
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define FILEWATCHER_INOTIFY
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+// Editors fire several events per save, report each path once
+static void AddChanged(std::vector<std::string>& changed, const std::string& path)
+{
+    for (const std::string& existing : changed) {
+        if (existing == path) return;
+    }
+    changed.push_back(path);
+}
+
+FileWatcher::FileWatcher()
+{
+#ifdef FILEWATCHER_INOTIFY
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        TraceLog(LOG_WARNING, "WATCH: inotify unavailable, falling back to polling");
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef FILEWATCHER_INOTIFY
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+#endif
+}
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    if (!FileExists(path.c_str())) {
+        TraceLog(LOG_WARNING, "WATCH: File not found, not watching: %s", path.c_str());
+        return false;
+    }
+
+    WatchedFile file;
+    file.path = path;
+    file.fileName = GetFileName(path.c_str());
+    file.dirWatch = -1;
+    file.modTime = GetFileModTime(path.c_str());
+
+#ifdef FILEWATCHER_INOTIFY
+    if (inotifyFd >= 0) {
+        // Watch the directory, editors often save by writing a new file and renaming it over the old one
+        std::string dir = path.substr(0, path.size() - file.fileName.size());
+        if (dir.empty()) dir = ".";
+        file.dirWatch = inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (file.dirWatch < 0) {
+            TraceLog(LOG_WARNING, "WATCH: inotify_add_watch failed for %s, polling it instead", dir.c_str());
+        }
+    }
+#endif
+
+    files.push_back(file);
+    return true;
+}
+
+bool FileWatcher::IsUsingInotify() const
+{
+    return inotifyFd >= 0;
+}
+
+void FileWatcher::Poll(std::vector<std::string>& changed)
+{
+#ifdef FILEWATCHER_INOTIFY
+    if (inotifyFd >= 0) {
+        alignas(struct inotify_event) char buffer[4096];
+        for (;;) {
+            ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;  // EAGAIN, nothing pending
+            }
+            for (char* ptr = buffer; ptr < buffer + length; ) {
+                const struct inotify_event* event = (const struct inotify_event*)ptr;
+                ptr += sizeof(struct inotify_event) + event->len;
+                if (event->len == 0) continue;
+
+                for (WatchedFile& file : files) {
+                    if (file.dirWatch == event->wd && file.fileName == event->name) {
+                        AddChanged(changed, file.path);
+                    }
+                }
+            }
+        }
+    }
+#endif
+    PollModTimes(changed);
+}
+
+void FileWatcher::PollModTimes(std::vector<std::string>& changed)
+{
+    double now = GetTime();
+    if (now - lastPollTime < pollInterval) {
+        return;
+    }
+    lastPollTime = now;
+
+    for (WatchedFile& file : files) {
+        if (file.dirWatch >= 0) continue;  // Covered by inotify
+
+        long modTime = GetFileModTime(file.path.c_str());
+        if (modTime != file.modTime) {
+            file.modTime = modTime;
+            AddChanged(changed, file.path);
+        }
+    }
+}
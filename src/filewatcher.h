@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Watches a set of files and reports the ones that changed since the last Poll.
+// Uses inotify on Linux and falls back to polling modification times elsewhere.
+class FileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    bool Watch(const std::string& path);
+    // Appends the watched paths that changed since the last call to changed
+    void Poll(std::vector<std::string>& changed);
+    bool IsUsingInotify() const;
+
+    float pollInterval = 0.5f;  // Seconds between modification time checks in polling mode
+
+private:
+    struct WatchedFile
+    {
+        std::string path;
+        std::string fileName;
+        int dirWatch;
+        long modTime;
+    };
+
+    void PollModTimes(std::vector<std::string>& changed);
+
+    std::vector<WatchedFile> files;
+    int inotifyFd = -1;
+    double lastPollTime = 0.0;
+};
@@ -0,0 +1,220 @@
+#include <vector>
+#include <chrono>
+#include "raylib.h"
+#include "globals.h"
+#include "flowfield.h"
+#include "memtrack.h"
+
+// Neighbour offsets, index 0 is "no direction"
+static const int neighbourX[9] = {0, 1, 1, 0, -1, -1, -1, 0, 1};
+static const int neighbourY[9] = {0, 0, 1, 1, 1, 0, -1, -1, -1};
+// Step costs scaled by 10 so diagonals stay integers
+static const unsigned int stepCost[9] = {0, 10, 14, 10, 14, 10, 14, 10, 14};
+static const unsigned int unreachable = 0xFFFFFFFF;
+
+const Vector2 FlowField::directionVectors[9] = {
+    {0.0f, 0.0f},
+    {1.0f, 0.0f}, {0.70710678f, 0.70710678f}, {0.0f, 1.0f}, {-0.70710678f, 0.70710678f},
+    {-1.0f, 0.0f}, {-0.70710678f, -0.70710678f}, {0.0f, -1.0f}, {0.70710678f, -0.70710678f},
+};
+
+void FlowField::Build(int targetCell, std::vector<unsigned char>& output)
+{
+    int cellCount = columns * rows;
+    integration.assign(cellCount, unreachable);
+    output.assign(cellCount, 0);
+
+    // Dijkstra with a bucket queue: step costs are small integers, so cells are
+    // queued by exact cost in a ring of buckets instead of a heap
+    for (std::vector<int>& bucket : openBuckets) {
+        bucket.clear();
+    }
+    integration[targetCell] = 0;
+    openBuckets[0].push_back(targetCell);
+    int queued = 1;
+    for (unsigned int cost = 0; queued > 0; cost++) {
+        std::vector<int>& bucket = openBuckets[cost % openBucketCount];
+        // Steps cost at least 10, so nothing is added to this bucket while it is processed
+        for (size_t k = 0; k < bucket.size(); k++) {
+            int cell = bucket[k];
+            if (integration[cell] != cost) continue;    // Stale entry, the cell was reached cheaper since
+
+            int x = cell % columns;
+            int y = cell / columns;
+            for (int i = 1; i < 9; i++) {
+                int nx = x + neighbourX[i];
+                int ny = y + neighbourY[i];
+                if (nx < 0 || ny < 0 || nx >= columns || ny >= rows) continue;
+                int next = ny * columns + nx;
+                if (blocked[next]) continue;
+                // No cutting corners past a blocked tile
+                if (neighbourX[i] != 0 && neighbourY[i] != 0 && (blocked[y * columns + nx] || blocked[ny * columns + x])) continue;
+
+                unsigned int nextCost = cost + stepCost[i];
+                if (nextCost < integration[next]) {
+                    integration[next] = nextCost;
+                    openBuckets[nextCost % openBucketCount].push_back(next);
+                    queued++;
+                }
+            }
+        }
+        queued -= (int)bucket.size();
+        bucket.clear();
+    }
+
+    // Every reachable cell points at its cheapest neighbour
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns; x++) {
+            int cell = y * columns + x;
+            unsigned int best = integration[cell];
+            if (best == unreachable || best == 0) continue;
+            for (int i = 1; i < 9; i++) {
+                int nx = x + neighbourX[i];
+                int ny = y + neighbourY[i];
+                if (nx < 0 || ny < 0 || nx >= columns || ny >= rows) continue;
+                if (neighbourX[i] != 0 && neighbourY[i] != 0 && (blocked[y * columns + nx] || blocked[ny * columns + x])) continue;
+                unsigned int value = integration[ny * columns + nx];
+                if (value < best) {
+                    best = value;
+                    output[cell] = (unsigned char)i;
+                }
+            }
+        }
+    }
+}
+
+void FlowField::Init(const TileMap& map)
+{
+    MemTagScope memTag(MEMTAG_ENTITIES);
+#ifndef __EMSCRIPTEN__
+    // The worker reads the grid while building
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !building; });
+    hasRequest = false;
+#endif
+
+    columns = map.GetWidth();
+    rows = map.GetHeight();
+    cellSize = map.GetTileSize() > 0 ? map.GetTileSize() : 32;
+    inverseCellSize = 1.0f / cellSize;
+    int cellCount = columns * rows;
+    blocked.resize(cellCount);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns; x++) {
+            blocked[y * columns + x] = map.IsSolid(x, y) ? 1 : 0;
+        }
+    }
+
+    // Sized here so building a field does not allocate, whichever thread it runs on
+    directions.clear();
+    integration.reserve(cellCount);
+    for (std::vector<int>& bucket : openBuckets) {
+        bucket.reserve(cellCount / 4);
+    }
+#ifndef __EMSCRIPTEN__
+    buildDirections.reserve(cellCount);
+    finishedDirections.clear();
+    finishedDirections.reserve(cellCount);
+#endif
+    directions.reserve(cellCount);
+    hasResult = false;
+    requestedCell = -1;
+}
+
+void FlowField::SetTarget(Vector2 target)
+{
+    if (columns == 0 || rows == 0) return;
+    int cellX = (int)(target.x * inverseCellSize);
+    int cellY = (int)(target.y * inverseCellSize);
+    cellX = MAX(0, MIN(cellX, columns - 1));
+    cellY = MAX(0, MIN(cellY, rows - 1));
+    int cell = cellY * columns + cellX;
+    if (cell == requestedCell) return;
+    requestedCell = cell;
+
+#ifndef __EMSCRIPTEN__
+    {
+        // Replaces a request the worker hasn't started yet, only the latest target matters
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingCell = cell;
+        hasRequest = true;
+    }
+    wake.notify_one();
+#else
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Build(cell, directions);
+    lastBuildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    MetricsRecord(buildTimeMetric, lastBuildMs);
+    hasResult = true;
+#endif
+}
+
+bool FlowField::Update()
+{
+#ifndef __EMSCRIPTEN__
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!hasResult) return false;
+    directions.swap(finishedDirections);
+    lastBuildMs = finishedBuildMs;
+#else
+    if (!hasResult) return false;
+#endif
+    hasResult = false;
+    return true;
+}
+
+#ifndef __EMSCRIPTEN__
+
+FlowField::FlowField()
+{
+    buildTimeMetric = MetricsHistogram("game_flowfield_build_ms", "Time to build a flow field in milliseconds", 0.001);
+    thread = std::thread(&FlowField::ThreadMain, this);
+}
+
+FlowField::~FlowField()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void FlowField::ThreadMain()
+{
+    MemTagScope memTag(MEMTAG_ENTITIES);
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return hasRequest || quit; });
+        if (quit) return;
+
+        int cell = pendingCell;
+        hasRequest = false;
+        building = true;
+        lock.unlock();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Build(cell, buildDirections);
+        float buildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        MetricsRecord(buildTimeMetric, buildMs);
+
+        lock.lock();
+        buildDirections.swap(finishedDirections);
+        finishedBuildMs = buildMs;
+        hasResult = true;
+        building = false;
+        idle.notify_all();
+    }
+}
+
+#else
+
+FlowField::FlowField()
+{
+    buildTimeMetric = MetricsHistogram("game_flowfield_build_ms", "Time to build a flow field in milliseconds", 0.001);
+}
+
+FlowField::~FlowField() {}
+
+#endif
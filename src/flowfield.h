@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "raylib.h"
+#include "tilemap.h"
+#include "metrics.h"
+
+// Flow field over the tile grid of a level. Whenever the target moves to a
+// different tile the integration field (path cost to the target from every
+// tile) is rebuilt on a worker thread, and every tile stores the direction
+// of its cheapest neighbour. Agents then look up their direction with one
+// array read, no matter how many of them share the target.
+class FlowField
+{
+public:
+    FlowField();
+    ~FlowField();
+
+    // Copies the walkable tiles of map, call again after the level changed
+    void Init(const TileMap& map);
+    // Requests a field towards target (world coordinates), ignored while the target stays in the same tile
+    void SetTarget(Vector2 target);
+    // Picks up a finished field from the worker, returns true when a new one was taken
+    bool Update();
+
+    // Unit direction to follow from a world position, zero at the target and where it can't be reached
+    Vector2 GetDirection(float x, float y) const
+    {
+        int cell = CellIndex(x, y);
+        return (cell < 0 || directions.empty()) ? Vector2{0, 0} : directionVectors[directions[cell]];
+    }
+    bool IsBlocked(float x, float y) const
+    {
+        int cell = CellIndex(x, y);
+        return cell < 0 || blocked[cell] != 0;
+    }
+
+    bool IsReady() const { return !directions.empty(); }
+    float GetLastBuildMs() const { return lastBuildMs; }
+    int GetColumns() const { return columns; }
+    int GetRows() const { return rows; }
+    int GetCellSize() const { return cellSize; }
+
+private:
+    int CellIndex(float x, float y) const
+    {
+        if (x < 0.0f || y < 0.0f) return -1;
+        int cellX = (int)(x * inverseCellSize);
+        int cellY = (int)(y * inverseCellSize);
+        return (cellX < columns && cellY < rows) ? cellY * columns + cellX : -1;
+    }
+
+    // Builds the field towards targetCell into output, only reads blocked
+    void Build(int targetCell, std::vector<unsigned char>& output);
+
+    static const Vector2 directionVectors[9];
+
+    int columns = 0;
+    int rows = 0;
+    int cellSize = 32;
+    float inverseCellSize = 1.0f / 32.0f;
+    std::vector<unsigned char> blocked;
+    std::vector<unsigned char> directions;  // Index into directionVectors per cell, read by agents
+
+    // Scratch buffers of Build, only used by the thread building the field
+    std::vector<unsigned int> integration;
+    static const int openBucketCount = 16;  // More than the largest step cost
+    std::vector<int> openBuckets[openBucketCount];
+
+    int requestedCell = -1;
+    bool hasResult = false;     // A field was built since the last Update
+    float lastBuildMs = 0.0f;
+    MetricId buildTimeMetric;
+
+#ifndef __EMSCRIPTEN__
+    void ThreadMain();
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::vector<unsigned char> buildDirections;     // Owned by the worker while building
+    std::vector<unsigned char> finishedDirections;  // Waiting for Update, guarded by mutex
+    int pendingCell = -1;
+    bool hasRequest = false;
+    bool building = false;
+    float finishedBuildMs = 0.0f;
+    bool quit = false;
+#endif
+};
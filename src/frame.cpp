@@ -0,0 +1,83 @@
+#include "raylib.h"
+#include "frame.h"
+
+#if defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+
+static const double fpsInterval = 0.5;
+
+static double targetFrameTime = 0.0;
+static double frameStart = 0.0;
+static float frameTime = 0.0f;
+static double fpsStart = 0.0;
+static int fpsFrames = 0;
+static int fps = 0;
+
+void FrameSetTargetFps(int targetFps)
+{
+    targetFrameTime = (targetFps > 0) ? 1.0 / targetFps : 0.0;
+}
+
+void FrameEnd(const std::function<void()>& presented)
+{
+    EndDrawing();
+    // With vsync this is where the frame waits for the display
+    SwapScreenBuffer();
+    if (presented) {
+        presented();
+    }
+
+    // Same limiter as raylib's EndDrawing, input is polled after the wait so the next frame gets the freshest state
+    double now = GetTime();
+    if (frameStart > 0.0 && now - frameStart < targetFrameTime) {
+        WaitTime(targetFrameTime - (now - frameStart));
+        now = GetTime();
+    }
+    frameTime = (frameStart > 0.0) ? (float)(now - frameStart) : 0.0f;
+    frameStart = now;
+    PollInputEvents();
+
+    fpsFrames++;
+    if (now - fpsStart >= fpsInterval) {
+        fps = (fpsStart > 0.0) ? (int)(fpsFrames / (now - fpsStart) + 0.5) : 0;
+        fpsStart = now;
+        fpsFrames = 0;
+    }
+}
+
+float FrameGetTime()
+{
+    return frameTime;
+}
+
+int FrameGetFps()
+{
+    return fps;
+}
+
+#else
+
+void FrameSetTargetFps(int targetFps)
+{
+    SetTargetFPS(targetFps);
+}
+
+void FrameEnd(const std::function<void()>& presented)
+{
+    // raylib swaps and polls inside EndDrawing, this is as late as the game can look
+    if (presented) {
+        presented();
+    }
+    EndDrawing();
+}
+
+float FrameGetTime()
+{
+    return GetFrameTime();
+}
+
+int FrameGetFps()
+{
+    return GetFPS();
+}
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+
+// Ends frames in place of EndDrawing. When raylib is built with
+// SUPPORT_CUSTOM_FRAME_CONTROL (desktop CMake builds, see CMakeLists.txt)
+// EndDrawing only draws what is batched, and swapping the buffers, waiting
+// for the target frame rate and polling input happen here instead, so the
+// time a frame was presented can be taken right after the swap. Other builds
+// (web, build_web.sh) leave all of it to raylib.
+
+// 0 runs without a frame limiter, like SetTargetFPS
+void FrameSetTargetFps(int targetFps);
+// Call instead of EndDrawing. presented runs once the frame was handed to the
+// display, and before input for the next frame is polled.
+void FrameEnd(const std::function<void()>& presented);
+
+// Seconds the last frame took and frames per second, in place of
+// GetFrameTime and GetFPS which raylib no longer updates with custom frame control
+float FrameGetTime();
+int FrameGetFps();
@@ -2,9 +2,15 @@
 #include <utility>
 #include <string>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include "raylib.h"
 #include "globals.h"
 #include "game.h"
+#include "tuning.h"
+#include "memtrack.h"
+#include "metrics.h"
+#include "frame.h"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -12,14 +18,61 @@
 
 bool Game::isMobile = false;
 
+static const char* fontPath = "data/PressStart2P-Regular.ttf";
+static const char* musicPath = "data/music.mp3";
+static const char* soundPath = "data/action.mp3";
+static const char* tuningPath = "data/tuning.txt";
+static const char* levelPath = "data/level.map";
+static const char* atlasPath = "data/sprites.atlas";
+static const char* propSpriteNames[] = {"rock", "bush", "crate", "barrel", "flower", "pebble", "tree"};
+static const float frameBudgetMs = 1000.0f / 144.0f;
+// LoadFontEx(fontPath, fontSize, 0, 0) loads raylib's default 95 glyphs,
+// padded like FONT_TTF_DEFAULT_CHARS_PADDING in rtext.c
+static const int fontSize = 64;
+static const int fontGlyphCount = 95;
+static const int fontGlyphPadding = 4;
+
+#ifndef EMSCRIPTEN_BUILD
+// Hot reload watches data/ in the source tree when the build says where it is
+// (GAME_SOURCE_DATA_DIR, see CMakeLists.txt), the copy in the build directory
+// only changes when CMake runs again. Generated files such as level.map and
+// sprites.atlas only exist in the build directory and are watched there.
+static std::string WatchedPath(const char* path)
+{
+#ifdef GAME_SOURCE_DATA_DIR
+    std::string sourcePath = std::string(GAME_SOURCE_DATA_DIR) + "/" + GetFileName(path);
+    if (FileExists(sourcePath.c_str())) {
+        return sourcePath;
+    }
+#endif
+    return path;
+}
+
+// Watched files are told apart by name, they may be in the source tree or the build directory
+static bool IsAsset(const std::string& watchedPath, const char* assetPath)
+{
+    return strcmp(GetFileName(watchedPath.c_str()), GetFileName(assetPath)) == 0;
+}
+#endif
+
 Game::Game(int width, int height)
 {
     isInitialLaunch = true;
-    ballX = width / 2;
-    ballY = height / 2;
+    ballX = worldWidth / 2;
+    ballY = worldHeight / 2;
     ballRadius = 50;
     ballSpeed = 300.0f;
     ballColor = RED;
+    LoadTuning();
+
+    camera.offset = {gameScreenWidth / 2.0f, gameScreenHeight / 2.0f};
+    camera.target = {ballX, ballY};
+    camera.rotation = 0.0f;
+    camera.zoom = 1.0f;
+    propGrid.Init((float)worldWidth, (float)worldHeight, 256.0f);
+    tileMap.Load(levelPath);
+    flowField.Init(tileMap);
+    flowField.SetTarget({ballX, ballY});
 
 #ifdef __EMSCRIPTEN__
     isMobile = EM_ASM_INT({
@@ -27,36 +80,71 @@ Game::Game(int width, int height)
     });
 #endif
 
-    targetRenderTex = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
-    SetTextureFilter(targetRenderTex.texture, TEXTURE_FILTER_BILINEAR);
-    font = LoadFontEx("data/PressStart2P-Regular.ttf", 64, 0, 0);
+    {
+        MemTagScope memTag(MEMTAG_RENDER);
+        targetRenderTex = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
+        SetTextureFilter(targetRenderTex.texture, TEXTURE_FILTER_BILINEAR);
+        MemTrackGpu(MEMTAG_RENDER, MemRenderTextureBytes(targetRenderTex));
+    }
+    LoadSprites();
+    {
+        MemTagScope memTag(MEMTAG_FONT);
+        font = LoadFontEx(fontPath, fontSize, 0, 0);
+        MemTrackGpu(MEMTAG_FONT, MemTextureBytes(font.texture));
+    }
     musicVolume = 0.10f;
     soundVolume = 0.5f;
 
-    backgroundMusic = LoadMusicStream("data/music.mp3");
+    MemTagScope audioTag(MEMTAG_AUDIO);
+    backgroundMusic = LoadMusicStream(musicPath);
     if (backgroundMusic.stream.buffer == NULL) {
-        TraceLog(LOG_ERROR, "Failed to load music file: data/music.mp3");
+        TraceLog(LOG_ERROR, "Failed to load music file: %s", musicPath);
     } else {
         TraceLog(LOG_INFO, "Music loaded successfully");
         SetMusicVolume(backgroundMusic, musicVolume);
         isMusicPlaying = false;
     }
 
-    actionSound = LoadSound("data/action.mp3");
+    actionSound = LoadSound(soundPath);
     if (actionSound.stream.buffer == NULL) {
-        TraceLog(LOG_ERROR, "Failed to load sound file: data/action.mp3");
+        TraceLog(LOG_ERROR, "Failed to load sound file: %s", soundPath);
     } else {
         TraceLog(LOG_INFO, "Action sound loaded successfully");
         SetSoundVolume(actionSound, soundVolume);
     }
     this->width = width;
     this->height = height;
+
+#ifndef EMSCRIPTEN_BUILD
+    assetWatcher.Watch(WatchedPath(tuningPath));
+    assetWatcher.Watch(WatchedPath(fontPath));
+    assetWatcher.Watch(WatchedPath(musicPath));
+    assetWatcher.Watch(WatchedPath(soundPath));
+    // The text map being edited, the converted level.map is only made by the build
+    std::string levelSource = WatchedPath("data/level.csv");
+    assetWatcher.Watch(levelSource != "data/level.csv" ? levelSource : std::string(levelPath));
+    assetWatcher.Watch(atlasPath);
+    TraceLog(LOG_INFO, "Hot reload enabled (%s)", assetWatcher.IsUsingInotify() ? "inotify" : "polling");
+#endif
+    AddSystems();
+    RegisterMetrics();
     InitGame();
 }
 
 Game::~Game()
 {
+    MetricsSetSocket("");
+    MetricsSetFile("", 0.0f, 0);
+#ifndef EMSCRIPTEN_BUILD
+    if (reloading) {
+        reloadThread.join();
+        UnloadDecodedAsset(decodedAsset);
+    }
+#endif
+
+    MemTrackGpu(MEMTAG_RENDER, -MemRenderTextureBytes(targetRenderTex));
     UnloadRenderTexture(targetRenderTex);
+    MemTrackGpu(MEMTAG_FONT, -MemTextureBytes(font.texture));
     UnloadFont(font);
     UnloadMusicStream(backgroundMusic);
     UnloadSound(actionSound);
@@ -83,87 +171,535 @@ void Game::Reset()
     isInMainMenu = false;
     isInitialLaunch = false;
     isMusicPlaying = true;
-    ballX = width / 2;
-    ballY = height / 2;
+    ballX = worldWidth / 2;
+    ballY = worldHeight / 2;
+    camera.target = {ballX, ballY};
 }
 
 void Game::Update(float dt)
 {
+    // With threaded recording the world shows this frame's input one frame later, except a late latched player
+    latency.BeginFrame((threadedRenderRecording && !lateLatchInput) ? 1 : 0);
     if (dt == 0)
     {
         return;
     }
 
-    screenScale = MIN((float)GetScreenWidth() / gameScreenWidth, (float)GetScreenHeight() / gameScreenHeight);
-    UpdateUI();
+    if (IsKeyPressed(KEY_F2)) {
+        showMemoryOverlay = !showMemoryOverlay;
+    }
+    if (IsKeyPressed(KEY_F3)) {
+        lateLatchInput = !lateLatchInput;
+    }
+    if (IsKeyPressed(KEY_F4)) {
+        showSystemsOverlay = !showSystemsOverlay;
+    }
+
+    tickDt = dt;
+    systems.Run();
+
+    MetricsAdd(framesMetric);
+    MetricsRecord(frameTimeMetric, dt * 1000.0f);
+    MetricsRecord(updateTimeMetric, systems.GetLastTickMs());
+    for (int i = 0; i < systems.GetSystemCount(); i++) {
+        MetricsRecord(systemTimeMetrics[i], systems.GetStats(i).lastMs);
+    }
+    // After the systems ran, so the collector can read everything without racing them
+    MetricsUpdate([this] { CollectMetrics(); });
 
+    if (showSystemsOverlay) {
+        // Copied for the same reason as the memory stats
+        for (int i = 0; i < systems.GetSystemCount(); i++) {
+            systemStats[i] = systems.GetStats(i);
+        }
+        systemsTickMs = systems.GetLastTickMs();
+    }
+}
+
+void Game::AddSystems()
+{
+    // Added in the order Update used to call them in, conflicting systems keep that order
+    systems.AddSystem("hot_reload", 0, RES_ALL, true, [this] {
+        UpdateHotReload();
+        atlas.Update();
+    });
+    systems.AddSystem("memory", 0, RES_MEMORY_STATS, false, [this] {
+        MemTrackUpdate();
+        if (showMemoryOverlay) {
+            // Copied here so a threaded RecordFrame never reads the counters while they are updated
+            for (int i = 0; i < MEMTAG_COUNT; i++) {
+                memoryStats[i] = MemTrackGetStats((MemTag)i);
+            }
+        }
+    });
+    // Window queries, so it stays on the main thread
+    systems.AddSystem("ui", RES_INPUT, RES_UI | RES_AUDIO | RES_PLAYER | RES_CAMERA, true, [this] {
+        screenScale = MIN((float)GetScreenWidth() / gameScreenWidth, (float)GetScreenHeight() / gameScreenHeight);
+        UpdateUI();
+        // Only run game logic if no menus are open and game is not paused
+        isPlaying = (!lostWindowFocus && 
+                     !isInMainMenu && 
+                     !isInOptionsMenu && 
+                     !isInExitConfirmation && 
+                     !gameOver);
+    });
+    systems.AddSystem("audio", RES_INPUT | RES_UI, RES_AUDIO, false, [this] {
+        UpdateAudio();
+    });
+    systems.AddSystem("player", RES_INPUT | RES_UI | RES_CAMERA, RES_PLAYER, false, [this] {
+        if (isPlaying) HandleInput();
+    });
+    systems.AddSystem("camera", RES_UI | RES_PLAYER, RES_CAMERA, false, [this] {
+        if (isPlaying) UpdateCamera(tickDt);
+    });
+    // The field is rebuilt on the worker only when the ball enters another tile,
+    // agents keep following the previous field until the new one is picked up
+    systems.AddSystem("flow_field", RES_PLAYER, RES_FLOWFIELD, false, [this] {
+        flowField.SetTarget({ballX, ballY});
+        flowField.Update();
+    });
+    systems.AddSystem("agents", RES_UI | RES_FLOWFIELD, RES_AGENTS, false, [this] {
+        if (isPlaying) agents.Update(tickDt, flowField);
+    });
+    // Stream level chunks in and out around the camera, also while a menu is showing the world.
+    // Builds chunk render textures, so it needs the GL context.
+    systems.AddSystem("tilemap", RES_CAMERA, RES_TILEMAP, true, [this] {
+        tileMap.Update(GetCameraView());
+    });
+    systemStats.resize(systems.GetSystemCount());
+}
+
+void Game::RegisterMetrics()
+{
+    framesMetric = MetricsCounter("game_frames_total", "Frames updated");
+    frameTimeMetric = MetricsHistogram("game_frame_time_ms", "Time between frames in milliseconds", 0.01);
+    updateTimeMetric = MetricsHistogram("game_update_time_ms", "Time to run all update systems in milliseconds", 0.001);
+    for (int i = 0; i < systems.GetSystemCount(); i++) {
+        std::string labels = std::string("system=\"") + systems.GetStats(i).name + "\"";
+        systemTimeMetrics.push_back(MetricsHistogram("game_system_time_ms", "Time of one update system in milliseconds", 0.001, labels.c_str()));
+    }
+    audioUnderrunMetric = MetricsCounter("game_audio_underruns_total",
+        "Music updates that came later than one stream buffer (1/30 s), so the stream likely ran dry");
+    agentsMetric = MetricsGauge("game_agents", "Agents in the world");
+    propsMetric = MetricsGauge("game_props", "Props in the world");
+    renderCommandsMetric = MetricsGauge("game_render_commands", "Draw commands submitted in the last frame");
+    droppedCommandsMetric = MetricsGauge("game_render_dropped_commands", "Draw commands dropped in the last frame, the render queue was full");
+    fpsMetric = MetricsGauge("game_fps", "Frames per second as measured by raylib");
+    const char* latencyLabels[3] = {"percentile=\"50\"", "percentile=\"95\"", "percentile=\"99\""};
+    for (int i = 0; i < 3; i++) {
+        latencyMetrics[i] = MetricsGauge("game_input_latency_ms", "Input to present latency over the last 1024 inputs", latencyLabels[i]);
+    }
+    for (int i = 0; i < MEMTAG_COUNT; i++) {
+        std::string labels = std::string("tag=\"") + MemTagName((MemTag)i) + "\"";
+        memoryLiveMetrics[i] = MetricsGauge("game_memory_live_bytes", "Heap bytes allocated per memory tag", labels.c_str());
+        memoryGpuMetrics[i] = MetricsGauge("game_memory_gpu_bytes", "GPU bytes owned per memory tag", labels.c_str());
+        memoryAllocationRateMetrics[i] = MetricsGauge("game_memory_allocations_per_second", "Allocations per second per memory tag", labels.c_str());
+    }
+}
+
+void Game::CollectMetrics()
+{
+    MetricsSet(agentsMetric, agents.GetCount());
+    MetricsSet(propsMetric, (double)worldProps.size());
+    MetricsSet(renderCommandsMetric, lastRenderStats.commands);
+    MetricsSet(droppedCommandsMetric, lastRenderStats.dropped);
+    MetricsSet(fpsMetric, displayedFps);
+    const LatencyStats& latencyStats = latency.GetStats();
+    MetricsSet(latencyMetrics[0], latencyStats.p50Ms);
+    MetricsSet(latencyMetrics[1], latencyStats.p95Ms);
+    MetricsSet(latencyMetrics[2], latencyStats.p99Ms);
+    for (int i = 0; i < MEMTAG_COUNT; i++) {
+        MemTagStats stats = MemTrackGetStats((MemTag)i);
+        MetricsSet(memoryLiveMetrics[i], (double)stats.liveBytes);
+        MetricsSet(memoryGpuMetrics[i], (double)stats.gpuBytes);
+        MetricsSet(memoryAllocationRateMetrics[i], stats.allocationsPerSecond);
+    }
+}
+
+void Game::UpdateAudio()
+{
     if (isMusicPlaying) {
+        // raylib doesn't report underruns, a late refill is the closest visible sign
+        double now = GetTime();
+        if (lastMusicUpdateTime > 0.0 && now - lastMusicUpdateTime > 1.0 / 30.0 && backgroundMusic.stream.buffer != NULL) {
+            MetricsAdd(audioUnderrunMetric);
+        }
+        lastMusicUpdateTime = now;
         UpdateMusicStream(backgroundMusic);
+    } else {
+        lastMusicUpdateTime = 0.0;
     }
 
-    // Only run game logic if no menus are open and game is not paused
-    bool running = (!lostWindowFocus && 
-                   !isInMainMenu && 
-                   !isInOptionsMenu && 
-                   !isInExitConfirmation && 
-                   !gameOver);
-
-    if (running)
-    {
-        HandleInput();
+    if (isPlaying && !isMobile && IsKeyPressed(KEY_SPACE)) {
+        if (actionSound.stream.buffer != NULL) {
+            StopSound(actionSound);
+            PlaySound(actionSound);
+        }
     }
 }
 
 void Game::HandleInput()
 {
-    float dt = GetFrameTime();
+    float dt = tickDt;
+    inputSampleTime = GetTime();
 
+    Vector2 direction = GetMoveDirection();
+    ballX += direction.x * ballSpeed * dt;
+    ballY += direction.y * ballSpeed * dt;
+
+    // Keep the ball inside the world
+    ballX = MAX((float)ballRadius, MIN(ballX, (float)(worldWidth - ballRadius)));
+    ballY = MAX((float)ballRadius, MIN(ballY, (float)(worldHeight - ballRadius)));
+}
+
+Vector2 Game::GetMoveDirection() const
+{
+    Vector2 direction = {0, 0};
     if(!isMobile) {
         if(IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) {
-            ballY -= ballSpeed * dt;
+            direction.y = -1.0f;
         }
         else if(IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) {
-            ballY += ballSpeed * dt;
+            direction.y = 1.0f;
         }
 
         if(IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) {
-            ballX -= ballSpeed * dt;
+            direction.x = -1.0f;
         }
         else if(IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) {
-            ballX += ballSpeed * dt;
-        }
-
-        if (IsKeyPressed(KEY_SPACE)) {
-            if (actionSound.stream.buffer != NULL) {
-                StopSound(actionSound);
-                PlaySound(actionSound);
-            } 
+            direction.x = 1.0f;
         }
     } 
     else // mobile controls
     {
         if(IsGestureDetected(GESTURE_DRAG) || IsGestureDetected(GESTURE_HOLD)) {
             Vector2 touchPosition = GetTouchPosition(0);
-            // Convert screen coordinates to game coordinates
+            // Convert screen coordinates to game coordinates, then to world coordinates
             float gameX = (touchPosition.x - (GetScreenWidth() - (gameScreenWidth * screenScale)) * 0.5f) / screenScale;
             float gameY = (touchPosition.y - (GetScreenHeight() - (gameScreenHeight * screenScale)) * 0.5f) / screenScale;
+            Vector2 worldPosition = GetScreenToWorld2D({gameX, gameY}, camera);
             
-            Vector2 ballCenter = { ballX, ballY };
-            Vector2 direction = { gameX - ballCenter.x, gameY - ballCenter.y };
+            direction = { worldPosition.x - ballX, worldPosition.y - ballY };
             
             // Normalize the direction vector
             float length = sqrtf(direction.x * direction.x + direction.y * direction.y);
             if(length > 0) {
                 direction.x /= length;
                 direction.y /= length;
-                
-                ballX += direction.x * ballSpeed * dt;
-                ballY += direction.y * ballSpeed * dt;
             }
         }
     }
+    return direction;
 }
 
+Vector2 Game::GetLateLatchedBallPosition() const
+{
+    Vector2 position = {ballX, ballY};
+    if (!isPlaying) {
+        return position;
+    }
+
+    // Input is only polled once per frame in FrameEnd, so the freshest input is the state
+    // HandleInput read; the ball is moved on by the time passed since then,
+    // capped so a hitch doesn't throw it ahead
+    float elapsed = MIN((float)(GetTime() - inputSampleTime), 1.0f / 30.0f);
+    Vector2 direction = GetMoveDirection();
+    position.x += direction.x * ballSpeed * elapsed;
+    position.y += direction.y * ballSpeed * elapsed;
+    position.x = MAX((float)ballRadius, MIN(position.x, (float)(worldWidth - ballRadius)));
+    position.y = MAX((float)ballRadius, MIN(position.y, (float)(worldHeight - ballRadius)));
+    return position;
+}
+
+void Game::UpdateCamera(float dt)
+{
+    // Exponential smoothing, frame rate independent
+    float t = 1.0f - expf(-cameraFollowSpeed * dt);
+    camera.target.x += (ballX - camera.target.x) * t;
+    camera.target.y += (ballY - camera.target.y) * t;
+
+    // Don't show anything outside the world
+    float halfViewWidth = camera.offset.x / camera.zoom;
+    float halfViewHeight = camera.offset.y / camera.zoom;
+    camera.target.x = MAX(halfViewWidth, MIN(camera.target.x, worldWidth - halfViewWidth));
+    camera.target.y = MAX(halfViewHeight, MIN(camera.target.y, worldHeight - halfViewHeight));
+}
+
+Rectangle Game::GetCameraView() const
+{
+    float viewWidth = gameScreenWidth / camera.zoom;
+    float viewHeight = gameScreenHeight / camera.zoom;
+    return {camera.target.x - camera.offset.x / camera.zoom, camera.target.y - camera.offset.y / camera.zoom, viewWidth, viewHeight};
+}
+
+void Game::LoadTuning()
+{
+    TuningFile tuning;
+    if (tuning.Load(tuningPath)) {
+        ApplyTuning(tuning);
+    }
+}
+
+void Game::ApplyTuning(const TuningFile& tuning)
+{
+    tuning.GetFloat("ballSpeed", ballSpeed);
+    tuning.GetInt("ballRadius", ballRadius);
+    tuning.GetColor("ballColor", ballColor);
+    tuning.GetFloat("keyRepeatDelay", keyRepeatDelay);
+    tuning.GetFloat("keyRepeatInterval", keyRepeatInterval);
+    tuning.GetFloat("cameraFollowSpeed", cameraFollowSpeed);
+    tuning.GetInt("agentCount", agentCount);
+    tuning.GetFloat("agentSpeed", agents.speed);
+    int lateLatch = lateLatchInput ? 1 : 0;
+    tuning.GetInt("lateLatchInput", lateLatch);
+    lateLatchInput = (lateLatch != 0);
+    // Metrics export, an empty path turns it off
+    std::string metricsSocket;
+    tuning.GetString("metricsSocket", metricsSocket);
+    MetricsSetSocket(metricsSocket);
+    std::string metricsFile;
+    float metricsFileInterval = 10.0f;
+    float metricsFileMaxMb = 16.0f;
+    tuning.GetString("metricsFile", metricsFile);
+    tuning.GetFloat("metricsFileInterval", metricsFileInterval);
+    tuning.GetFloat("metricsFileMaxMb", metricsFileMaxMb);
+    MetricsSetFile(metricsFile, metricsFileInterval, (long long)(metricsFileMaxMb * 1024.0f * 1024.0f));
+
+    int serialSystems = 0;
+    tuning.GetInt("serialSystems", serialSystems);
+    systems.SetSerial(serialSystems != 0);
+    int threaded = threadedRenderRecording ? 1 : 0;
+    tuning.GetInt("threadedRenderRecording", threaded);
+    threadedRenderRecording = (threaded != 0);
+    tuning.GetColor("black", black);
+    tuning.GetColor("darkGreen", darkGreen);
+    tuning.GetColor("grey", grey);
+    tuning.GetColor("yellow", yellow);
+
+    // Per tag budgets in MB, for example "renderBudgetMb = 16"
+    for (int i = 0; i < MEMTAG_COUNT; i++) {
+        std::string key = std::string(MemTagName((MemTag)i)) + "BudgetMb";
+        float budgetMb = 0.0f;
+        tuning.GetFloat(key.c_str(), budgetMb);
+        MemTrackSetBudget((MemTag)i, (long long)(budgetMb * 1024.0f * 1024.0f));
+    }
+}
+
+void Game::LoadSprites()
+{
+    // Without an atlas (e.g. build_web.sh does not pack one) everything falls back to shapes
+    if (!atlas.Load(atlasPath)) {
+        TraceLog(LOG_WARNING, "Drawing without sprites, %s is missing", atlasPath);
+        return;
+    }
+    UseAtlasSprites();
+}
+
+void Game::UseAtlasSprites()
+{
+    atlas.UseForShapes();
+    for (int i = 0; i < propSpriteCount; i++) {
+        propSprites[i] = atlas.GetSprite(propSpriteNames[i]);
+    }
+    agentSprite = atlas.GetSprite("agent");
+}
+
+void Game::UpdateHotReload()
+{
+#ifndef EMSCRIPTEN_BUILD
+    assetWatcher.Poll(pendingReloads);
+
+    // One file at a time, so saving several files at once doesn't stack GPU uploads into one frame
+    if (reloading) {
+        if (!reloadDecoded.load(std::memory_order_acquire)) {
+            return;
+        }
+        reloadThread.join();
+        reloading = false;
+
+        double start = GetTime();
+        ApplyReload(decodedAsset);
+        float elapsedMs = (float)((GetTime() - start) * 1000.0);
+        if (elapsedMs > frameBudgetMs) {
+            TraceLog(LOG_WARNING, "Swapping in %s took %.2f ms, over the %.2f ms frame budget", decodedAsset.path.c_str(), elapsedMs, frameBudgetMs);
+        } else {
+            TraceLog(LOG_INFO, "Reloaded %s, decoded in %.2f ms on the loader thread, swapped in in %.2f ms",
+                decodedAsset.path.c_str(), decodedAsset.decodeMs, elapsedMs);
+        }
+        decodedAsset = DecodedAsset();
+    }
+
+    if (!pendingReloads.empty()) {
+        decodedAsset.path = pendingReloads.front();
+        pendingReloads.erase(pendingReloads.begin());
+        reloadDecoded.store(false, std::memory_order_relaxed);
+        reloading = true;
+        reloadThread = std::thread([this] {
+            double start = GetTime();
+            DecodeAsset(decodedAsset);
+            decodedAsset.decodeMs = (float)((GetTime() - start) * 1000.0);
+            reloadDecoded.store(true, std::memory_order_release);
+        });
+    }
+#endif
+}
+
+#ifndef EMSCRIPTEN_BUILD
+
+void Game::DecodeAsset(DecodedAsset& asset)
+{
+    // Runs on the loader thread: file reads and decoding only, nothing that touches GL or the game state
+    const char* path = asset.path.c_str();
+    if (IsAsset(asset.path, tuningPath))
+    {
+        asset.valid = asset.tuning.Load(path);
+    }
+    else if (IsAsset(asset.path, fontPath))
+    {
+        // LoadFontEx without the texture upload
+        MemTagScope memTag(MEMTAG_FONT);
+        int dataSize = 0;
+        unsigned char* fileData = LoadFileData(path, &dataSize);
+        if (fileData == NULL) return;
+        asset.glyphs = LoadFontData(fileData, dataSize, fontSize, NULL, fontGlyphCount, FONT_DEFAULT);
+        UnloadFileData(fileData);
+        if (asset.glyphs == NULL) return;
+        asset.fontAtlas = GenImageFontAtlas(asset.glyphs, &asset.glyphRecs, fontGlyphCount, fontSize, fontGlyphPadding, 0);
+        if (asset.fontAtlas.data == NULL) return;
+        // Glyph images are cut from the atlas like LoadFontEx does, for ImageDrawText
+        for (int i = 0; i < fontGlyphCount; i++) {
+            UnloadImage(asset.glyphs[i].image);
+            asset.glyphs[i].image = ImageFromImage(asset.fontAtlas, asset.glyphRecs[i]);
+        }
+        asset.valid = true;
+    }
+    else if (IsAsset(asset.path, musicPath))
+    {
+        // Opening the decoder reads through the whole file to find its length.
+        // raylib's audio calls lock its mixer, the audio system already runs off the main thread.
+        MemTagScope memTag(MEMTAG_AUDIO);
+        asset.music = LoadMusicStream(path);
+        asset.valid = (asset.music.stream.buffer != NULL);
+    }
+    else if (IsAsset(asset.path, soundPath))
+    {
+        MemTagScope memTag(MEMTAG_AUDIO);
+        asset.wave = LoadWave(path);
+        asset.valid = (asset.wave.data != NULL);
+    }
+    else if (IsAsset(asset.path, atlasPath))
+    {
+        asset.valid = SpriteAtlas::Decode(path, asset.atlas);
+    }
+    else
+    {
+        asset.valid = TileMap::ReadMap(path, asset.level);
+    }
+}
+
+void Game::ApplyReload(DecodedAsset& asset)
+{
+    // The old resource stays when decoding failed, a half saved file must not break the game
+    if (!asset.valid)
+    {
+        TraceLog(LOG_WARNING, "Failed to reload %s", asset.path.c_str());
+        UnloadDecodedAsset(asset);
+        return;
+    }
+
+    if (IsAsset(asset.path, tuningPath))
+    {
+        ApplyTuning(asset.tuning);
+        if (agentCount != agents.GetCount()) {
+            agents.Spawn(agentCount, flowField);
+        }
+    }
+    else if (IsAsset(asset.path, fontPath))
+    {
+        MemTagScope memTag(MEMTAG_FONT);
+        Font newFont = {};
+        newFont.baseSize = fontSize;
+        newFont.glyphCount = fontGlyphCount;
+        newFont.glyphPadding = fontGlyphPadding;
+        newFont.texture = LoadTextureFromImage(asset.fontAtlas);
+        if (newFont.texture.id == 0) {
+            TraceLog(LOG_WARNING, "Failed to upload font: %s", asset.path.c_str());
+            UnloadDecodedAsset(asset);
+            return;
+        }
+        newFont.glyphs = asset.glyphs;
+        newFont.recs = asset.glyphRecs;
+        UnloadImage(asset.fontAtlas);
+        asset.glyphs = nullptr;
+        asset.glyphRecs = nullptr;
+        asset.fontAtlas = Image{};
+
+        MemTrackGpu(MEMTAG_FONT, MemTextureBytes(newFont.texture) - MemTextureBytes(font.texture));
+        UnloadFont(font);
+        font = newFont;
+    }
+    else if (IsAsset(asset.path, musicPath))
+    {
+        MemTagScope memTag(MEMTAG_AUDIO);
+        float timePlayed = GetMusicTimePlayed(backgroundMusic);
+        UnloadMusicStream(backgroundMusic);
+        backgroundMusic = asset.music;
+        asset.music = Music{};
+        SetMusicVolume(backgroundMusic, musicVolume);
+        PlayMusicStream(backgroundMusic);
+        if (timePlayed < GetMusicTimeLength(backgroundMusic)) {
+            SeekMusicStream(backgroundMusic, timePlayed);
+        }
+    }
+    else if (IsAsset(asset.path, soundPath))
+    {
+        MemTagScope memTag(MEMTAG_AUDIO);
+        Sound newSound = LoadSoundFromWave(asset.wave);
+        UnloadWave(asset.wave);
+        asset.wave = Wave{};
+        if (newSound.stream.buffer == NULL) {
+            TraceLog(LOG_WARNING, "Failed to reload sound file: %s", soundPath);
+            return;
+        }
+        UnloadSound(actionSound);
+        actionSound = newSound;
+        SetSoundVolume(actionSound, soundVolume);
+    }
+    else if (IsAsset(asset.path, atlasPath))
+    {
+        if (atlas.Upload(asset.atlas)) {
+            UseAtlasSprites();
+        }
+    }
+    else
+    {
+        tileMap.Reload(asset.level);
+        flowField.Init(tileMap);
+    }
+}
+
+void Game::UnloadDecodedAsset(DecodedAsset& asset)
+{
+    if (asset.glyphs != NULL) UnloadFontData(asset.glyphs, fontGlyphCount);
+    if (asset.glyphRecs != NULL) MemFree(asset.glyphRecs);
+    if (asset.fontAtlas.data != NULL) UnloadImage(asset.fontAtlas);
+    asset.glyphs = nullptr;
+    asset.glyphRecs = nullptr;
+    asset.fontAtlas = Image{};
+
+    if (asset.music.stream.buffer != NULL) UnloadMusicStream(asset.music);
+    if (asset.wave.data != NULL) UnloadWave(asset.wave);
+    asset.music = Music{};
+    asset.wave = Wave{};
+
+    for (Image& page : asset.atlas.pages) {
+        UnloadImage(page);
+    }
+    asset.atlas.pages.clear();
+}
+
+#endif
+
 void Game::UpdateMenu()
 {
     if (isInMainMenu)
@@ -296,7 +832,7 @@ void Game::UpdateMenu()
             }
         }
         // Handle key repeat for options menu navigation and volume adjustment
-        float dt = GetFrameTime();
+        float dt = tickDt;
         
         // Handle UP/DOWN navigation with auto-repeat
         bool upPressed = IsKeyDown(KEY_UP) || IsKeyDown(KEY_W);
@@ -643,41 +1179,41 @@ void Game::UpdateUI()
     UpdateMenu();
 }
 
-void Game::DrawUI()
+void Game::DrawUI(RenderQueue& queue)
 {
     if (isInMainMenu)
     {
-        DrawMainMenu();
+        DrawMainMenu(queue);
     }
     else if (isInOptionsMenu)
     {
-        DrawOptionsMenu();
+        DrawOptionsMenu(queue);
     }
     else if (isInExitConfirmation)
     {
-        DrawRectangleRounded({(float)(gameScreenWidth / 2 - 250), (float)(gameScreenHeight / 2 - 30), 500.0f, 60.0f}, 0.76f, 20, BLACK);
-        DrawText("Are you sure you want to exit? (Y/N)", gameScreenWidth / 2 - 200, gameScreenHeight / 2 - 10, 20, WHITE);
+        queue.AddRectangleRounded(LAYER_UI_BACKGROUND, {(float)(gameScreenWidth / 2 - 250), (float)(gameScreenHeight / 2 - 30), 500.0f, 60.0f}, 0.76f, 20, BLACK);
+        queue.AddText(LAYER_UI, "Are you sure you want to exit? (Y/N)", gameScreenWidth / 2 - 200, gameScreenHeight / 2 - 10, 20, WHITE);
     }
     else if (lostWindowFocus)
     {
-        DrawRectangleRounded({(float)(gameScreenWidth / 2 - 250), (float)(gameScreenHeight / 2 - 30), 500.0f, 60.0f}, 0.76f, 20, BLACK);
-        DrawText("Game paused, focus window to continue", gameScreenWidth / 2 - 200, gameScreenHeight / 2 - 10, 20, WHITE);
+        queue.AddRectangleRounded(LAYER_UI_BACKGROUND, {(float)(gameScreenWidth / 2 - 250), (float)(gameScreenHeight / 2 - 30), 500.0f, 60.0f}, 0.76f, 20, BLACK);
+        queue.AddText(LAYER_UI, "Game paused, focus window to continue", gameScreenWidth / 2 - 200, gameScreenHeight / 2 - 10, 20, WHITE);
     }
     else if (gameOver)
     {
-        DrawRectangleRounded({(float)(gameScreenWidth / 2 - 250), (float)(gameScreenHeight / 2 - 30), 500.0f, 60.0f}, 0.76f, 20, BLACK);
-        DrawText("Game over, press Enter to play again", gameScreenWidth / 2 - 200, gameScreenHeight / 2, 20, YELLOW);
+        queue.AddRectangleRounded(LAYER_UI_BACKGROUND, {(float)(gameScreenWidth / 2 - 250), (float)(gameScreenHeight / 2 - 30), 500.0f, 60.0f}, 0.76f, 20, BLACK);
+        queue.AddText(LAYER_UI, "Game over, press Enter to play again", gameScreenWidth / 2 - 200, gameScreenHeight / 2, 20, YELLOW);
     }
 }
 
-void Game::DrawMainMenu()
+void Game::DrawMainMenu(RenderQueue& queue)
 {
     const int menuStartY = gameScreenHeight / 2 - 100;
     const int menuStartX = gameScreenWidth / 2 - 150;
     const int menuItemHeight = 50;
 
     // Draw menu background
-    DrawRectangle(menuStartX - 10, menuStartY - 10, 320, 220, {0, 0, 0, 200});
+    queue.AddRectangle(LAYER_UI_BACKGROUND, {(float)(menuStartX - 10), (float)(menuStartY - 10), 320.0f, 220.0f}, {0, 0, 0, 200});
 
     // Draw menu items
     const char* menuItems[] = {"Continue", "New Game", "Options", "Quit Game"};
@@ -696,11 +1232,11 @@ void Game::DrawMainMenu()
         {
             textColor = WHITE;
         }
-        DrawText(menuItems[i], menuStartX, menuStartY + i * menuItemHeight, 20, textColor);
+        queue.AddText(LAYER_UI, menuItems[i], menuStartX, menuStartY + i * menuItemHeight, 20, textColor);
     }  
 }
 
-void Game::DrawOptionsMenu()
+void Game::DrawOptionsMenu(RenderQueue& queue)
 {
     const int menuStartY = gameScreenHeight / 2 - 120;
     const int menuStartX = gameScreenWidth / 2 - 200;
@@ -711,51 +1247,148 @@ void Game::DrawOptionsMenu()
     const int menuHeight = 280;
 
     // Draw menu background
-    DrawRectangle(menuStartX - 10, menuStartY - 10, menuWidth, menuHeight, {0, 0, 0, 200});
+    queue.AddRectangle(LAYER_UI_BACKGROUND, {(float)(menuStartX - 10), (float)(menuStartY - 10), (float)menuWidth, (float)menuHeight}, {0, 0, 0, 200});
 
     // Draw menu title
-    DrawText("Options", menuStartX, menuStartY, 20, WHITE);
+    queue.AddText(LAYER_UI, "Options", menuStartX, menuStartY, 20, WHITE);
 
     // Draw sound volume slider
-    DrawText("Sound Volume", menuStartX, menuStartY + menuItemHeight, 20, 
+    queue.AddText(LAYER_UI, "Sound Volume", menuStartX, menuStartY + menuItemHeight, 20, 
             (optionsMenuSelection == 0) ? YELLOW : WHITE);
-    DrawRectangle(menuStartX + 150, menuStartY + menuItemHeight, sliderWidth, sliderHeight, GRAY);
-    DrawRectangle(menuStartX + 150, menuStartY + menuItemHeight, 
-                sliderWidth * soundVolume, sliderHeight, 
+    queue.AddRectangle(LAYER_UI_BACKGROUND, {(float)(menuStartX + 150), (float)(menuStartY + menuItemHeight), (float)sliderWidth, (float)sliderHeight}, GRAY);
+    queue.AddRectangle(LAYER_UI_BACKGROUND, {(float)(menuStartX + 150), (float)(menuStartY + menuItemHeight), 
+                (float)(int)(sliderWidth * soundVolume), (float)sliderHeight}, 
                 (optionsMenuSelection == 0) ? YELLOW : WHITE);
                 
     // Draw sound volume percentage
     char soundVolText[32];
     sprintf(soundVolText, "%d%%", (int)(soundVolume * 100));
-    DrawText(soundVolText, menuStartX + 150 + sliderWidth + 20, menuStartY + menuItemHeight, 20, WHITE);
+    queue.AddText(LAYER_UI, soundVolText, menuStartX + 150 + sliderWidth + 20, menuStartY + menuItemHeight, 20, WHITE);
 
     // Draw music volume slider
-    DrawText("Music Volume", menuStartX, menuStartY + menuItemHeight * 2, 20, 
+    queue.AddText(LAYER_UI, "Music Volume", menuStartX, menuStartY + menuItemHeight * 2, 20, 
             (optionsMenuSelection == 1) ? YELLOW : WHITE);
-    DrawRectangle(menuStartX + 150, menuStartY + menuItemHeight * 2, sliderWidth, sliderHeight, GRAY);
-    DrawRectangle(menuStartX + 150, menuStartY + menuItemHeight * 2, 
-                sliderWidth * musicVolume, sliderHeight, 
+    queue.AddRectangle(LAYER_UI_BACKGROUND, {(float)(menuStartX + 150), (float)(menuStartY + menuItemHeight * 2), (float)sliderWidth, (float)sliderHeight}, GRAY);
+    queue.AddRectangle(LAYER_UI_BACKGROUND, {(float)(menuStartX + 150), (float)(menuStartY + menuItemHeight * 2), 
+                (float)(int)(sliderWidth * musicVolume), (float)sliderHeight}, 
                 (optionsMenuSelection == 1) ? YELLOW : WHITE);
     // Draw music volume percentage
     char musicVolText[32];
     sprintf(musicVolText, "%d%%", (int)(musicVolume * 100));
-    DrawText(musicVolText, menuStartX + 150 + sliderWidth + 20, menuStartY + menuItemHeight * 2, 20, WHITE);
+    queue.AddText(LAYER_UI, musicVolText, menuStartX + 150 + sliderWidth + 20, menuStartY + menuItemHeight * 2, 20, WHITE);
 
     // Draw back button
-    DrawText("Back", menuStartX, menuStartY + menuItemHeight * 3, 20, 
+    queue.AddText(LAYER_UI, "Back", menuStartX, menuStartY + menuItemHeight * 3, 20, 
             (optionsMenuSelection == 2) ? YELLOW : WHITE);
 }
 
+void Game::RecordFrame(RenderQueue& queue)
+{
+    queue.Begin(camera);
+
+    Rectangle view = GetCameraView();
+    if (lateLatchInput) {
+        // The camera may be latched a frame further, more than it moves in one frame
+        const float latchMargin = 64.0f;
+        view = {view.x - latchMargin, view.y - latchMargin, view.width + latchMargin * 2, view.height + latchMargin * 2};
+    }
+    tileMap.Draw(queue, view);
+    visibleProps.clear();
+    propGrid.Query(view, visibleProps);
+    int visibleCount = 0;
+    for (int id : visibleProps)
+    {
+        const WorldProp& prop = worldProps[id];
+        Rectangle bounds = {prop.position.x - prop.radius, prop.position.y - prop.radius, prop.radius * 2, prop.radius * 2};
+        if (!CheckCollisionRecs(bounds, view)) continue;
+        visibleCount++;
+
+        const Sprite& sprite = propSprites[prop.sprite];
+        if (!sprite.IsValid()) {
+            queue.AddCircle(LAYER_PROPS, prop.position, prop.radius, prop.color);
+            continue;
+        }
+        // Fit the sprite into the prop's bounds, keeping its aspect ratio
+        float scale = prop.radius * 2 / MAX(sprite.Width(), sprite.Height());
+        float width = sprite.Width() * scale;
+        float height = sprite.Height() * scale;
+        queue.AddSprite(LAYER_PROPS, sprite, {prop.position.x - width / 2, prop.position.y - height / 2, width, height}, prop.color);
+    }
+    int visibleAgents = agents.Draw(queue, view, agentSprite);
+    queue.AddCircle(LAYER_PLAYER, {ballX, ballY}, (float)ballRadius, ballColor);
+    if (lateLatchInput) {
+        queue.MarkLateLatched();
+    }
+    queue.AddRectangleLines(LAYER_WORLD_OVERLAY, {0, 0, (float)worldWidth, (float)worldHeight}, 4, BLACK);
+
+    // Debug output, TextFormat is not thread safe so the text is formatted here
+    char text[128];
+    Color fpsColor = (displayedFps < 15) ? RED : (displayedFps < 30) ? ORANGE : LIME;
+    snprintf(text, sizeof(text), "%2i FPS", displayedFps);
+    queue.AddText(LAYER_HUD, text, 10, 10, 20, fpsColor);
+    snprintf(text, sizeof(text), "Visible: %d / %d", visibleCount, (int)worldProps.size());
+    queue.AddText(LAYER_HUD, text, 10, 35, 20, WHITE);
+    snprintf(text, sizeof(text), "Draw: %d cmds, %d texture switches, ~%d flushes (est.)",
+        lastRenderStats.commands, lastRenderStats.textureSwitches, lastRenderStats.estimatedFlushes);
+    queue.AddText(LAYER_HUD, text, 10, 60, 20, WHITE);
+    snprintf(text, sizeof(text), "Agents: %d / %d, flow field %.2f ms", visibleAgents, agents.GetCount(), flowField.GetLastBuildMs());
+    queue.AddText(LAYER_HUD, text, 10, 85, 20, WHITE);
+    const LatencyStats& latencyStats = latency.GetStats();
+    snprintf(text, sizeof(text), "Input latency p50 %.1f, p95 %.1f, p99 %.1f ms%s",
+        latencyStats.p50Ms, latencyStats.p95Ms, latencyStats.p99Ms, lateLatchInput ? ", late latch" : "");
+    queue.AddText(LAYER_HUD, text, 10, 110, 20, WHITE);
+    int overlayY = 145;
+    if (showMemoryOverlay) {
+        DrawMemoryOverlay(queue, overlayY);
+        overlayY += 22 * (MEMTAG_COUNT + 1) + 20;
+    }
+    if (showSystemsOverlay) {
+        DrawSystemsOverlay(queue, overlayY);
+    }
+
+    DrawUI(queue);
+    queue.Sort();
+}
+
 void Game::Draw()
 {
+    displayedFps = FrameGetFps();
+
+    // Threaded mode records this frame on the worker while the previous frame
+    // is submitted, at the cost of showing the world one frame late
+    RenderQueue* submitQueue = &renderQueues[currentRenderQueue];
+    if (threadedRenderRecording)
+    {
+        RenderQueue* recordQueue = submitQueue;
+        renderWorker.Run([this, recordQueue] { RecordFrame(*recordQueue); });
+        submitQueue = &renderQueues[1 - currentRenderQueue];
+    }
+    else
+    {
+        RecordFrame(*submitQueue);
+    }
+
+    // In threaded mode the submitted queue holds last frame's player and camera, latching moves both to the current ones
+    if (lateLatchInput)
+    {
+        submitQueue->LatchPosition(GetLateLatchedBallPosition());
+        submitQueue->LatchCamera(camera);
+    }
+
     // Render everything to the texture
     BeginTextureMode(targetRenderTex);
     ClearBackground(GRAY);
-    DrawCircle(ballX, ballY, ballRadius, ballColor);
-    DrawFPS(10, 10);
-    DrawUI();
+    submitQueue->Submit();
     EndTextureMode();
 
+    if (threadedRenderRecording)
+    {
+        renderWorker.Wait();
+        currentRenderQueue = 1 - currentRenderQueue;
+    }
+    // Only after the worker is done, its RecordFrame reads these for the HUD
+    lastRenderStats = submitQueue->GetStats();
+
     // Draw the texture to the screen
     BeginDrawing();    
     ClearBackground(BLACK);
@@ -769,7 +1402,55 @@ void Game::Draw()
         {0, 0},
         0,
         WHITE);
-    EndDrawing();
+    FrameEnd([this] { latency.FramePresented(); });
+}
+
+void Game::DrawMemoryOverlay(RenderQueue& queue, int y)
+{
+    const float mb = 1024.0f * 1024.0f;
+    const int x = 10;
+    const int lineHeight = 22;
+
+    queue.AddRectangle(LAYER_HUD_BACKGROUND, {(float)(x - 5), (float)(y - 5), 760.0f, (float)(lineHeight * (MEMTAG_COUNT + 1) + 10)}, {0, 0, 0, 180});
+    queue.AddText(LAYER_HUD, "Memory (MB)   live    peak     gpu  allocs/s  budget", x, y, 20, WHITE);
+
+    char text[128];
+    for (int i = 0; i < MEMTAG_COUNT; i++) {
+        const MemTagStats& stats = memoryStats[i];
+        long long used = stats.liveBytes + stats.gpuBytes;
+        Color color = (stats.budgetBytes > 0 && used > stats.budgetBytes) ? RED : WHITE;
+        if (stats.budgetBytes > 0) {
+            snprintf(text, sizeof(text), "%-10s %7.2f %7.2f %7.2f %9.0f %7.1f", MemTagName((MemTag)i),
+                stats.liveBytes / mb, stats.peakBytes / mb, stats.gpuBytes / mb, stats.allocationsPerSecond, stats.budgetBytes / mb);
+        } else {
+            snprintf(text, sizeof(text), "%-10s %7.2f %7.2f %7.2f %9.0f       -", MemTagName((MemTag)i),
+                stats.liveBytes / mb, stats.peakBytes / mb, stats.gpuBytes / mb, stats.allocationsPerSecond);
+        }
+        queue.AddText(LAYER_HUD, text, x, y + lineHeight * (i + 1), 20, color);
+    }
+}
+
+void Game::DrawSystemsOverlay(RenderQueue& queue, int y)
+{
+    const int x = 10;
+    const int lineHeight = 22;
+    int count = (int)systemStats.size();
+
+    queue.AddRectangle(LAYER_HUD_BACKGROUND, {(float)(x - 5), (float)(y - 5), 520.0f, (float)(lineHeight * (count + 2) + 10)}, {0, 0, 0, 180});
+    queue.AddText(LAYER_HUD, "Systems (ms)   last     avg    peak  thread", x, y, 20, WHITE);
+
+    char text[128];
+    for (int i = 0; i < count; i++) {
+        const SystemStats& stats = systemStats[i];
+        snprintf(text, sizeof(text), "%-11s %7.3f %7.3f %7.3f %7d", stats.name, stats.lastMs, stats.averageMs, stats.peakMs, stats.thread);
+        queue.AddText(LAYER_HUD, text, x, y + lineHeight * (i + 1), 20, WHITE);
+    }
+    if (systems.IsSerial()) {
+        snprintf(text, sizeof(text), "Tick %.3f ms, serial", systemsTickMs);
+    } else {
+        snprintf(text, sizeof(text), "Tick %.3f ms, %d workers", systemsTickMs, systems.GetWorkerCount());
+    }
+    queue.AddText(LAYER_HUD, text, x, y + lineHeight * (count + 1), 20, WHITE);
 }
 
 std::string Game::FormatWithLeadingZeroes(int number, int width)
@@ -782,4 +1463,24 @@ std::string Game::FormatWithLeadingZeroes(int number, int width)
 
 void Game::Randomize()
 {
+    MemTagScope memTag(MEMTAG_WORLD);
+    worldProps.clear();
+    propGrid.Clear();
+
+    const int propCount = 5000;
+    worldProps.reserve(propCount);
+    for (int i = 0; i < propCount; i++)
+    {
+        WorldProp prop;
+        prop.radius = (float)GetRandomValue(6, 30);
+        prop.position = {(float)GetRandomValue(0, worldWidth), (float)GetRandomValue(0, worldHeight)};
+        prop.sprite = GetRandomValue(0, propSpriteCount - 1);
+        prop.color = Color{(unsigned char)GetRandomValue(40, 220), (unsigned char)GetRandomValue(40, 220), (unsigned char)GetRandomValue(40, 220), 255};
+
+        Rectangle bounds = {prop.position.x - prop.radius, prop.position.y - prop.radius, prop.radius * 2, prop.radius * 2};
+        propGrid.Insert((int)worldProps.size(), bounds);
+        worldProps.push_back(prop);
+    }
+
+    agents.Spawn(agentCount, flowField);
 }
\ No newline at end of file
@@ -1,8 +1,38 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
 #include "raylib.h"
 #include "globals.h"
+#include "tuning.h"
+#include "filewatcher.h"
+#include "spatialgrid.h"
+#include "tilemap.h"
+#include "renderqueue.h"
+#include "flowfield.h"
+#include "agents.h"
+#include "spriteatlas.h"
+#include "memtrack.h"
+#include "latency.h"
+#include "scheduler.h"
+#include "metrics.h"
+
+// Resources the per tick systems declare access to, see Game::AddSystems
+enum GameResource
+{
+    RES_INPUT = 1 << 0,         // raylib input state
+    RES_UI = 1 << 1,            // Menu state, screen scale, whether the game is playing
+    RES_AUDIO = 1 << 2,         // Music, sounds and their volumes
+    RES_PLAYER = 1 << 3,
+    RES_CAMERA = 1 << 4,
+    RES_FLOWFIELD = 1 << 5,
+    RES_AGENTS = 1 << 6,
+    RES_TILEMAP = 1 << 7,
+    RES_MEMORY_STATS = 1 << 8,
+    RES_ALL = 0xFFFFFFFF
+};
 
 class Game
 {
@@ -12,16 +42,32 @@ public:
     void InitGame();
     void Reset();
     void Update(float dt);
+    void AddSystems();
+    void RegisterMetrics();
+    void CollectMetrics();
     void HandleInput();
+    void UpdateAudio();
+    Vector2 GetMoveDirection() const;
+    Vector2 GetLateLatchedBallPosition() const;
     void UpdateUI();
     void UpdateMenu();
 
     void Draw();
-    void DrawUI();
-    void DrawMainMenu();
-    void DrawOptionsMenu();
+    void RecordFrame(RenderQueue& queue);
+    void DrawUI(RenderQueue& queue);
+    void DrawMainMenu(RenderQueue& queue);
+    void DrawOptionsMenu(RenderQueue& queue);
+    void DrawMemoryOverlay(RenderQueue& queue, int y);
+    void DrawSystemsOverlay(RenderQueue& queue, int y);
     std::string FormatWithLeadingZeroes(int number, int width);
     void Randomize();
+    void UpdateCamera(float dt);
+    Rectangle GetCameraView() const;
+    void LoadTuning();
+    void ApplyTuning(const TuningFile& tuning);
+    void LoadSprites();
+    void UseAtlasSprites();
+    void UpdateHotReload();
 
     static bool isMobile;
 
@@ -66,6 +112,110 @@ private:
     float ballSpeed;
     Color ballColor;
 
+    // World view, the camera follows the ball and is kept inside the world bounds
+    Camera2D camera;
+    float cameraFollowSpeed = 8.0f;
+
+    // Draw commands are recorded into one queue while the other is submitted
+    RenderQueue renderQueues[2];
+    int currentRenderQueue = 0;
+    bool threadedRenderRecording = false;
+    RenderWorker renderWorker;
+    RenderStats lastRenderStats;
+    int displayedFps = 0;
+
+    // Input to present latency, and late latching of the player position right
+    // before the frame is submitted, toggled with F3
+    LatencyTracker latency;
+    bool lateLatchInput = false;
+    bool isPlaying = false;         // Game logic ran this frame
+    double inputSampleTime = 0.0;
+
+    // Update runs as systems, see AddSystems. Timings are shown with F4.
+    SystemScheduler systems;
+    float tickDt = 0.0f;
+    bool showSystemsOverlay = false;
+    std::vector<SystemStats> systemStats;
+    float systemsTickMs = 0.0f;
+
+    // Exported for soak runs, see metrics.h. Gauges are set by CollectMetrics when an export is due.
+    MetricId framesMetric;
+    MetricId frameTimeMetric;
+    MetricId updateTimeMetric;
+    std::vector<MetricId> systemTimeMetrics;
+    MetricId audioUnderrunMetric;
+    MetricId agentsMetric;
+    MetricId propsMetric;
+    MetricId renderCommandsMetric;
+    MetricId droppedCommandsMetric;
+    MetricId fpsMetric;
+    MetricId latencyMetrics[3];
+    MetricId memoryLiveMetrics[MEMTAG_COUNT];
+    MetricId memoryGpuMetrics[MEMTAG_COUNT];
+    MetricId memoryAllocationRateMetrics[MEMTAG_COUNT];
+    double lastMusicUpdateTime = 0.0;
+
+    // Per tag memory overlay, toggled with F2
+    bool showMemoryOverlay = false;
+    MemTagStats memoryStats[MEMTAG_COUNT];
+
+    // Level background, drawn from cached chunk textures
+    TileMap tileMap;
+
+    // Agents chasing the ball around obstacles
+    FlowField flowField;
+    AgentSwarm agents;
+    int agentCount = 2000;
+
+    // Props and agents are drawn from the sprite atlas, shapes come from its white region
+    static const int propSpriteCount = 7;
+    SpriteAtlas atlas;
+    Sprite propSprites[propSpriteCount];
+    Sprite agentSprite;
+
+    // Static world objects, only the ones overlapping the camera view are drawn
+    struct WorldProp
+    {
+        Vector2 position;
+        float radius;
+        int sprite;
+        Color color;
+    };
+    std::vector<WorldProp> worldProps;
+    SpatialGrid propGrid;
+    std::vector<int> visibleProps;
+
     Music backgroundMusic;
     Sound actionSound;
+
+    // Hot reload of assets and tuning values, desktop builds only. A changed
+    // file is decoded on reloadThread; the hot_reload system then only uploads
+    // it to the GPU and swaps it in, so a reload doesn't stall the frame.
+    FileWatcher assetWatcher;
+    std::vector<std::string> pendingReloads;
+#ifndef EMSCRIPTEN_BUILD
+    struct DecodedAsset
+    {
+        std::string path;
+        bool valid = false;
+        float decodeMs = 0.0f;
+        TuningFile tuning;
+        GlyphInfo* glyphs = nullptr;
+        Rectangle* glyphRecs = nullptr;
+        Image fontAtlas = {};
+        Music music = {};
+        Wave wave = {};
+        AtlasData atlas;
+        TileMapData level;
+    };
+
+    void DecodeAsset(DecodedAsset& asset);
+    void ApplyReload(DecodedAsset& asset);
+    void UnloadDecodedAsset(DecodedAsset& asset);
+
+    std::thread reloadThread;
+    std::atomic<bool> reloadDecoded{false};
+    bool reloading = false;
+    DecodedAsset decodedAsset;
+#endif
 };
\ No newline at end of file
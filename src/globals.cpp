@@ -9,6 +9,8 @@ int windowWidth = 1920;
 int windowHeight = 1080;
 const int gameScreenWidth = 960;
 const int gameScreenHeight = 540;
+const int worldWidth = 4096;
+const int worldHeight = 2304;
 bool optionWindowRequested = false;
 bool exitWindow = false;
 bool fullscreen = false;
@@ -12,6 +12,8 @@ extern Color grey;
 extern Color yellow;
 extern const int gameScreenWidth;
 extern const int gameScreenHeight;
+extern const int worldWidth;
+extern const int worldHeight;
 extern bool exitWindow;
 extern bool optionWindowRequested;
 extern bool fullscreen;
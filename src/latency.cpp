@@ -0,0 +1,90 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "raylib.h"
+#include "latency.h"
+
+static const double statsInterval = 0.5;
+static const double logInterval = 10.0;
+
+LatencyTracker::LatencyTracker()
+{
+    samples.resize(sampleCapacity);
+    sorted.reserve(sampleCapacity);
+}
+
+bool LatencyTracker::HasInputEvents()
+{
+    // A touch that is held still is not new input, only touching, lifting and dragging are
+    int touchCount = GetTouchPointCount();
+    Vector2 touchPosition = (touchCount > 0) ? GetTouchPosition(0) : Vector2{0, 0};
+    bool touchChanged = touchCount != lastTouchCount || touchPosition.x != lastTouchPosition.x || touchPosition.y != lastTouchPosition.y;
+    lastTouchCount = touchCount;
+    lastTouchPosition = touchPosition;
+    if (touchChanged) return true;
+
+    // Key and button edges instead of GetKeyPressed, which would empty raylib's queue for the game
+    for (int key = KEY_SPACE; key <= KEY_KB_MENU; key++) {
+        if (IsKeyPressed(key) || IsKeyReleased(key)) return true;
+    }
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_BACK; button++) {
+        if (IsMouseButtonPressed(button) || IsMouseButtonReleased(button)) return true;
+    }
+    Vector2 mouseDelta = GetMouseDelta();
+    return mouseDelta.x != 0.0f || mouseDelta.y != 0.0f;
+}
+
+void LatencyTracker::BeginFrame(int presentDelay)
+{
+    // Events delivered with the same poll share one timestamp and one sample
+    if (HasInputEvents() && pendingCount < pendingCapacity) {
+        pending[pendingCount].time = GetTime();
+        pending[pendingCount].presentFrame = frame + presentDelay;
+        pendingCount++;
+    }
+}
+
+void LatencyTracker::FramePresented()
+{
+    double now = GetTime();
+    int kept = 0;
+    for (int i = 0; i < pendingCount; i++) {
+        if (pending[i].presentFrame > frame) {
+            pending[kept++] = pending[i];
+            continue;
+        }
+        samples[nextSample] = (float)((now - pending[i].time) * 1000.0);
+        nextSample = (nextSample + 1) % sampleCapacity;
+        if (sampleCount < sampleCapacity) sampleCount++;
+    }
+    pendingCount = kept;
+    frame++;
+
+    if (now - lastStatsTime >= statsInterval) {
+        lastStatsTime = now;
+        UpdateStats();
+    }
+    if (now - lastLogTime >= logInterval && stats.samples > 0) {
+        lastLogTime = now;
+        TraceLog(LOG_INFO, "LATENCY: input to present p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms (%d samples)",
+            stats.p50Ms, stats.p95Ms, stats.p99Ms, stats.maxMs, stats.samples);
+    }
+}
+
+void LatencyTracker::UpdateStats()
+{
+    stats.samples = sampleCount;
+    if (sampleCount == 0) return;
+
+    sorted.assign(samples.begin(), samples.begin() + sampleCount);
+    std::sort(sorted.begin(), sorted.end());
+    // Nearest rank
+    auto percentile = [this](float p) {
+        int rank = (int)ceilf(p * sorted.size());
+        return sorted[std::max(rank, 1) - 1];
+    };
+    stats.p50Ms = percentile(0.50f);
+    stats.p95Ms = percentile(0.95f);
+    stats.p99Ms = percentile(0.99f);
+    stats.maxMs = sorted.back();
+}
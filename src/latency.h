@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+
+struct LatencyStats
+{
+    float p50Ms = 0.0f;
+    float p95Ms = 0.0f;
+    float p99Ms = 0.0f;
+    float maxMs = 0.0f;
+    int samples = 0;
+};
+
+// Input to present latency. raylib delivers input once per frame, when
+// FrameEnd polls events right before the next frame starts, so a frame that
+// sees new input events is timestamped when it starts. The sample is taken
+// once the frame showing the result of that input was swapped to the display
+// (see frame.h), which may be a later frame when rendering lags behind the
+// simulation. Time between the OS receiving an event and raylib's poll is not
+// visible here, it adds half a frame on average.
+class LatencyTracker
+{
+public:
+    LatencyTracker();
+
+    // Call before the game reads input. presentDelay is how many frames after
+    // this one the result of this frame's input is presented.
+    void BeginFrame(int presentDelay);
+    // Call once the frame was presented, from FrameEnd's callback
+    void FramePresented();
+
+    // Percentiles over the last sampleCapacity samples, refreshed twice a second
+    const LatencyStats& GetStats() const { return stats; }
+
+private:
+    bool HasInputEvents();
+    void UpdateStats();
+
+    struct PendingInput
+    {
+        double time;
+        unsigned long long presentFrame;
+    };
+
+    static const int sampleCapacity = 1024;
+    static const int pendingCapacity = 8;
+
+    unsigned long long frame = 0;
+    int lastTouchCount = 0;
+    Vector2 lastTouchPosition = {0, 0};
+    PendingInput pending[pendingCapacity];
+    int pendingCount = 0;
+    std::vector<float> samples;     // Ring of latencies in ms
+    std::vector<float> sorted;      // Scratch for the percentiles
+    int sampleCount = 0;
+    int nextSample = 0;
+    double lastStatsTime = 0.0;
+    double lastLogTime = 0.0;
+    LatencyStats stats;
+};
@@ -1,29 +1,74 @@
 #include "raylib.h"
 #include "globals.h"
 #include "game.h"
+#include "memtrack.h"
+#include "frame.h"
 #include <iostream>
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#include <emscripten/heap.h>
+#include <unistd.h>
 #endif
 
 Game* game = nullptr;
 
+#ifdef __EMSCRIPTEN__
+// Startup time, average frame cost and heap high-water mark, logged to the
+// browser console to size WEB_INITIAL_MEMORY and compare web build settings
+static double startupTime = 0.0;
+static double frameCostTotal = 0.0;
+static int measuredFrames = 0;
+static size_t heapHighWater = 0;
+
+static void LogWebStats(double frameStart)
+{
+    double now = emscripten_get_now();
+    if (measuredFrames == 0) {
+        TraceLog(LOG_INFO, "WEB: startup to first frame %.1f ms", now - startupTime);
+    }
+    frameCostTotal += now - frameStart;
+    measuredFrames++;
+    if (measuredFrames % 600 == 0) {
+        TraceLog(LOG_INFO, "WEB: average frame cost %.3f ms over %d frames", frameCostTotal / measuredFrames, measuredFrames);
+    }
+
+    size_t heapEnd = (size_t)sbrk(0);
+    if (heapEnd > heapHighWater) {
+        heapHighWater = heapEnd;
+        TraceLog(LOG_INFO, "WEB: heap high-water mark %.2f MB of %.2f MB", heapHighWater / (1024.0 * 1024.0),
+            emscripten_get_heap_size() / (1024.0 * 1024.0));
+    }
+}
+#endif
+
 void mainLoop()
 {
-    float dt = GetFrameTime();
+#ifdef __EMSCRIPTEN__
+    double frameStart = emscripten_get_now();
+#endif
+    float dt = FrameGetTime();
     game->Update(dt);
     game->Draw();
+#ifdef __EMSCRIPTEN__
+    LogWebStats(frameStart);
+#endif
 }
 
 int main()
 {
+#ifdef __EMSCRIPTEN__
+    startupTime = emscripten_get_now();
+#endif
     InitWindow(gameScreenWidth, gameScreenHeight, "Game Template");
     InitAudioDevice();
 #ifndef EMSCRIPTEN_BUILD
     SetWindowState(FLAG_WINDOW_RESIZABLE);
 #endif
     SetExitKey(KEY_NULL);
-    SetTargetFPS(144);
+#ifndef __EMSCRIPTEN__
+    // On the web requestAnimationFrame paces the loop, a frame limiter would only busy-wait
+    FrameSetTargetFps(144);
+#endif
     
     game = new Game(gameScreenWidth, gameScreenHeight);
     game->Randomize();
@@ -41,6 +86,8 @@ int main()
     delete game;
     CloseAudioDevice();
     CloseWindow();
+    // Peaks per tag, and anything still live here was leaked
+    MemTrackWriteJson("memory_report.json");
 #endif
 
     return 0;
@@ -0,0 +1,379 @@
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <string>
+#include <functional>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include "raylib.h"
+#include "memtrack.h"
+
+struct TagCounters
+{
+    std::atomic<long long> liveBytes;
+    std::atomic<long long> peakBytes;
+    std::atomic<long long> gpuBytes;
+    std::atomic<unsigned long long> allocations;
+    std::atomic<unsigned long long> frees;
+};
+
+static TagCounters counters[MEMTAG_COUNT];
+static std::atomic<long long> totalLiveBytes(0);
+static std::atomic<long long> totalPeakBytes(0);
+
+// Only touched from the thread calling MemTrackUpdate
+static long long budgets[MEMTAG_COUNT];
+static bool overBudget[MEMTAG_COUNT];
+static float allocationRates[MEMTAG_COUNT];
+static unsigned long long lastAllocations[MEMTAG_COUNT];
+static double lastRateTime = 0.0;
+
+static thread_local MemTag currentTag = MEMTAG_GENERAL;
+
+static const char* tagNames[MEMTAG_COUNT] = {
+    "general",
+    "render",
+    "font",
+    "audio",
+    "world",
+    "tilemap",
+    "entities",
+    "particles",
+};
+
+static void RaisePeak(std::atomic<long long>& peak, long long value)
+{
+    long long current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+static void CountAllocation(MemTag tagIndex, long long size)
+{
+    TagCounters& tag = counters[tagIndex];
+    long long live = tag.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    RaisePeak(tag.peakBytes, live);
+    tag.allocations.fetch_add(1, std::memory_order_relaxed);
+    long long total = totalLiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    RaisePeak(totalPeakBytes, total);
+}
+
+static void CountFree(MemTag tagIndex, long long size)
+{
+    TagCounters& tag = counters[tagIndex];
+    tag.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    tag.frees.fetch_add(1, std::memory_order_relaxed);
+    totalLiveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// Allocator for the block table, which must not count itself through operator new
+template <typename T>
+struct UntrackedAllocator
+{
+    typedef T value_type;
+
+    UntrackedAllocator() = default;
+    template <typename U>
+    UntrackedAllocator(const UntrackedAllocator<U>&) {}
+
+    T* allocate(std::size_t count)
+    {
+        T* ptr = (T*)malloc(count * sizeof(T));
+        if (ptr == nullptr) throw std::bad_alloc();
+        return ptr;
+    }
+    void deallocate(T* ptr, std::size_t) { free(ptr); }
+
+    template <typename U>
+    bool operator==(const UntrackedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const UntrackedAllocator<U>&) const { return false; }
+};
+
+// C allocations (raylib) carry no header, so a block released through a
+// different path than the one that counted it cannot corrupt the heap.
+// Their size and tag are kept in a table instead, and a free is credited to
+// the tag that allocated the block, whichever thread and tag free it
+struct CBlock
+{
+    size_t size;
+    MemTag tag;
+};
+typedef std::unordered_map<void*, CBlock, std::hash<void*>, std::equal_to<void*>,
+    UntrackedAllocator<std::pair<void* const, CBlock>>> CBlockTable;
+
+static std::mutex cBlockMutex;
+
+// Never destroyed, raylib may free blocks after static destructors ran
+static CBlockTable& CBlocks()
+{
+    static CBlockTable* table = new (malloc(sizeof(CBlockTable))) CBlockTable();
+    return *table;
+}
+
+static void CountMalloc(void* ptr, size_t size, MemTag tag)
+{
+    if (ptr == nullptr) return;
+    {
+        std::lock_guard<std::mutex> lock(cBlockMutex);
+        CBlocks()[ptr] = CBlock{size, tag};
+    }
+    CountAllocation(tag, (long long)size);
+}
+
+// Removes the block before the allocator can hand its address out again.
+// Blocks allocated before tracking started are not in the table and not counted
+static bool CountMallocFree(void* ptr, CBlock& block)
+{
+    if (ptr == nullptr) return false;
+    {
+        std::lock_guard<std::mutex> lock(cBlockMutex);
+        CBlockTable::iterator found = CBlocks().find(ptr);
+        if (found == CBlocks().end()) return false;
+        block = found->second;
+        CBlocks().erase(found);
+    }
+    CountFree(block.tag, (long long)block.size);
+    return true;
+}
+
+// operator new blocks always come back through operator delete, so they carry
+// a small header with their size and tag and are always credited back to the
+// tag that allocated them
+struct NewHeader
+{
+    size_t size;
+    MemTag tag;
+};
+static const size_t newHeaderSize = (sizeof(NewHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+static void* TrackedNew(std::size_t size)
+{
+    char* block = (char*)malloc(newHeaderSize + size);
+    if (block == nullptr) return nullptr;
+    NewHeader* header = (NewHeader*)block;
+    header->size = size;
+    header->tag = currentTag;
+    CountAllocation(header->tag, (long long)size);
+    return block + newHeaderSize;
+}
+
+static void TrackedDelete(void* ptr)
+{
+    if (ptr == nullptr) return;
+    char* block = (char*)ptr - newHeaderSize;
+    NewHeader* header = (NewHeader*)block;
+    CountFree(header->tag, (long long)header->size);
+    free(block);
+}
+
+MemTagScope::MemTagScope(MemTag tag)
+{
+    previous = currentTag;
+    currentTag = tag;
+}
+
+MemTagScope::~MemTagScope()
+{
+    currentTag = previous;
+}
+
+const char* MemTagName(MemTag tag)
+{
+    return (tag >= 0 && tag < MEMTAG_COUNT) ? tagNames[tag] : "unknown";
+}
+
+MemTag MemTagCurrent()
+{
+    return currentTag;
+}
+
+void MemTrackGpu(MemTag tag, long long bytes)
+{
+    counters[tag].gpuBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+long long MemTextureBytes(Texture2D texture)
+{
+    if (texture.id == 0) return 0;
+    return GetPixelDataSize(texture.width, texture.height, texture.format);
+}
+
+long long MemRenderTextureBytes(RenderTexture2D target)
+{
+    if (target.id == 0) return 0;
+    // Color attachment plus a 24 bit depth renderbuffer, which drivers pad to 32 bits
+    return MemTextureBytes(target.texture) + (long long)target.texture.width * target.texture.height * 4;
+}
+
+void MemTrackSetBudget(MemTag tag, long long bytes)
+{
+    budgets[tag] = bytes;
+    overBudget[tag] = false;
+}
+
+void MemTrackUpdate()
+{
+    double now = GetTime();
+    if (now - lastRateTime >= 1.0) {
+        float elapsed = (float)(now - lastRateTime);
+        for (int i = 0; i < MEMTAG_COUNT; i++) {
+            unsigned long long allocations = counters[i].allocations.load(std::memory_order_relaxed);
+            allocationRates[i] = (lastRateTime > 0.0) ? (allocations - lastAllocations[i]) / elapsed : 0.0f;
+            lastAllocations[i] = allocations;
+        }
+        lastRateTime = now;
+    }
+
+    for (int i = 0; i < MEMTAG_COUNT; i++) {
+        if (budgets[i] <= 0) continue;
+        long long used = counters[i].liveBytes.load(std::memory_order_relaxed) + counters[i].gpuBytes.load(std::memory_order_relaxed);
+        bool over = used > budgets[i];
+        // Warn when crossing the budget, not every frame while above it
+        if (over && !overBudget[i]) {
+            TraceLog(LOG_WARNING, "MEMORY: %s uses %.2f MB, over its %.2f MB budget", tagNames[i],
+                used / (1024.0 * 1024.0), budgets[i] / (1024.0 * 1024.0));
+        }
+        overBudget[i] = over;
+    }
+}
+
+MemTagStats MemTrackGetStats(MemTag tag)
+{
+    MemTagStats stats;
+    stats.liveBytes = counters[tag].liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters[tag].peakBytes.load(std::memory_order_relaxed);
+    stats.gpuBytes = counters[tag].gpuBytes.load(std::memory_order_relaxed);
+    stats.allocations = counters[tag].allocations.load(std::memory_order_relaxed);
+    stats.frees = counters[tag].frees.load(std::memory_order_relaxed);
+    stats.allocationsPerSecond = allocationRates[tag];
+    stats.budgetBytes = budgets[tag];
+    return stats;
+}
+
+unsigned long long MemTrackTotalAllocations()
+{
+    unsigned long long total = 0;
+    for (int i = 0; i < MEMTAG_COUNT; i++) {
+        total += counters[i].allocations.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::string MemTrackToJson()
+{
+    std::string json = "{\n  \"tags\": [\n";
+    char line[512];
+    for (int i = 0; i < MEMTAG_COUNT; i++) {
+        MemTagStats stats = MemTrackGetStats((MemTag)i);
+        snprintf(line, sizeof(line),
+            "    {\"name\": \"%s\", \"live_bytes\": %lld, \"peak_bytes\": %lld, \"gpu_bytes\": %lld, "
+            "\"allocations\": %llu, \"frees\": %llu, \"allocations_per_sec\": %.1f, \"budget_bytes\": %lld}%s\n",
+            tagNames[i], stats.liveBytes, stats.peakBytes, stats.gpuBytes, stats.allocations, stats.frees,
+            stats.allocationsPerSecond, stats.budgetBytes, (i + 1 < MEMTAG_COUNT) ? "," : "");
+        json += line;
+    }
+    snprintf(line, sizeof(line), "  ],\n  \"total_live_bytes\": %lld,\n  \"total_peak_bytes\": %lld\n}\n",
+        totalLiveBytes.load(std::memory_order_relaxed), totalPeakBytes.load(std::memory_order_relaxed));
+    json += line;
+    return json;
+}
+
+bool MemTrackWriteJson(const char* path)
+{
+    std::string json = MemTrackToJson();
+    return SaveFileData(path, (void*)json.c_str(), (int)json.size());
+}
+
+extern "C" void* MemTrackMalloc(size_t size)
+{
+    void* ptr = malloc(size);
+    CountMalloc(ptr, size, currentTag);
+    return ptr;
+}
+
+extern "C" void* MemTrackCalloc(size_t count, size_t size)
+{
+    void* ptr = calloc(count, size);
+    CountMalloc(ptr, count * size, currentTag);
+    return ptr;
+}
+
+extern "C" void* MemTrackRealloc(void* ptr, size_t size)
+{
+    // A grown block stays with the tag that allocated it
+    CBlock block = {0, currentTag};
+    bool tracked = CountMallocFree(ptr, block);
+    void* newPtr = realloc(ptr, size);
+    if (newPtr != nullptr) {
+        CountMalloc(newPtr, size, block.tag);
+    } else if (tracked && size > 0) {
+        // On failure the old block is still alive
+        CountMalloc(ptr, block.size, block.tag);
+    }
+    return newPtr;
+}
+
+extern "C" void MemTrackFree(void* ptr)
+{
+    CBlock block;
+    CountMallocFree(ptr, block);
+    free(ptr);
+}
+
+// Global operator new/delete, everything allocated through C++ is counted
+void* operator new(std::size_t size)
+{
+    void* ptr = TrackedNew(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedNew(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedNew(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    TrackedDelete(ptr);
+}
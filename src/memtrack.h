@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include "raylib.h"
+
+// Tagged memory accounting. Every operator new is counted against the tag
+// that is current on the calling thread, and so are raylib's own allocations
+// when raylib is built with MEMTRACK_RAYLIB (see CMakeLists.txt). A free is
+// always credited back to the tag that allocated the block.
+// GPU resources are not heap memory, they are reported separately per tag
+// through MemTrackGpu.
+enum MemTag
+{
+    MEMTAG_GENERAL = 0,
+    MEMTAG_RENDER,
+    MEMTAG_FONT,
+    MEMTAG_AUDIO,
+    MEMTAG_WORLD,
+    MEMTAG_TILEMAP,
+    MEMTAG_ENTITIES,
+    MEMTAG_PARTICLES,
+    MEMTAG_COUNT
+};
+
+struct MemTagStats
+{
+    long long liveBytes = 0;
+    long long peakBytes = 0;
+    long long gpuBytes = 0;
+    unsigned long long allocations = 0;
+    unsigned long long frees = 0;
+    float allocationsPerSecond = 0.0f;
+    long long budgetBytes = 0;  // 0 means no budget
+};
+
+// Makes tag current on this thread for the lifetime of the scope
+class MemTagScope
+{
+public:
+    explicit MemTagScope(MemTag tag);
+    ~MemTagScope();
+
+private:
+    MemTag previous;
+};
+
+const char* MemTagName(MemTag tag);
+MemTag MemTagCurrent();
+
+// Adds (or with a negative value removes) GPU memory owned by a tag
+void MemTrackGpu(MemTag tag, long long bytes);
+long long MemTextureBytes(Texture2D texture);
+long long MemRenderTextureBytes(RenderTexture2D target);
+
+void MemTrackSetBudget(MemTag tag, long long bytes);
+// Updates allocation rates and warns about exceeded budgets, call once per frame
+void MemTrackUpdate();
+MemTagStats MemTrackGetStats(MemTag tag);
+unsigned long long MemTrackTotalAllocations();
+
+std::string MemTrackToJson();
+bool MemTrackWriteJson(const char* path);
+
+extern "C" {
+// Allocator entry points for raylib when it is compiled with MEMTRACK_RAYLIB,
+// see memtrack_raylib.h
+void* MemTrackMalloc(size_t size);
+void* MemTrackCalloc(size_t count, size_t size);
+void* MemTrackRealloc(void* ptr, size_t size);
+void MemTrackFree(void* ptr);
+}
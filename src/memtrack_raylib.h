@@ -0,0 +1,28 @@
+#ifndef MEMTRACK_RAYLIB_H
+#define MEMTRACK_RAYLIB_H
+
+// Force included into raylib's C sources when MEMTRACK_RAYLIB is enabled (see
+// CMakeLists.txt), so raylib and the libraries it bundles allocate through
+// memtrack and their memory shows up under the caller's tag
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void* MemTrackMalloc(size_t size);
+void* MemTrackCalloc(size_t count, size_t size);
+void* MemTrackRealloc(void* ptr, size_t size);
+void MemTrackFree(void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define RL_MALLOC(sz) MemTrackMalloc(sz)
+#define RL_CALLOC(n, sz) MemTrackCalloc(n, sz)
+#define RL_REALLOC(ptr, sz) MemTrackRealloc(ptr, sz)
+#define RL_FREE(ptr) MemTrackFree(ptr)
+
+#endif
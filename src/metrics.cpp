@@ -0,0 +1,541 @@
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <utility>
+#include <cmath>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include "raylib.h"
+#include "metrics.h"
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#define METRICS_UNIX_SOCKET
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static const int maxCounters = 64;
+static const int maxGauges = 128;
+static const int maxHistograms = 32;
+
+// Log-linear buckets as in HdrHistogram: values below linearLimit get a
+// bucket each, above that every power of two is split into subBucketCount
+// buckets, so a bucket is at most 1/16 of its value wide
+static const int linearLimit = 32;
+static const int subBucketCount = 16;
+static const int maxExponent = 31;
+static const int histogramBuckets = linearLimit + maxExponent * subBucketCount;
+
+static const double acceptInterval = 0.1;
+// A scraper that hasn't read its snapshot by then is dropped
+static const double clientTimeout = 5.0;
+static const int maxClients = 8;
+static const char* httpHeader = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n\r\n";
+
+enum MetricKind
+{
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+};
+
+struct MetricInfo
+{
+    MetricKind kind;
+    int slot;
+    std::string name;
+    std::string help;
+    std::string labels;
+};
+
+struct HistogramShard
+{
+    std::atomic<unsigned int> buckets[histogramBuckets];
+    std::atomic<double> sum;
+};
+
+// Written only by the thread owning it, so recording is a relaxed load and
+// store instead of a locked read-modify-write. Kept after the thread exits,
+// its counts still belong to the totals.
+struct MetricsShard
+{
+    std::atomic<unsigned long long> counters[maxCounters];
+    HistogramShard histograms[maxHistograms];
+    MetricsShard* next;
+};
+
+// Registration and export, guarded by registryMutex
+static std::mutex registryMutex;
+static std::vector<MetricInfo> metrics;
+static int counterCount = 0;
+static int gaugeCount = 0;
+static int histogramCount = 0;
+
+// Read by the recording threads, written before the id is handed out
+static double histogramScale[maxHistograms];
+static std::atomic<double> gauges[maxGauges];
+static std::atomic<MetricsShard*> firstShard(nullptr);
+static thread_local MetricsShard* localShard = nullptr;
+
+// Export targets, only touched from the thread calling MetricsUpdate
+static std::string socketPath;
+static int listenSocket = -1;
+static double lastAcceptTime = 0.0;
+
+#ifdef METRICS_UNIX_SOCKET
+// A scrape being answered, sent a piece per frame as far as the socket takes it
+struct MetricsClient
+{
+    int fd;
+    std::string response;
+    size_t sent;
+    double acceptTime;
+};
+static std::vector<MetricsClient> clients;
+#endif
+static std::string filePath;
+static float fileInterval = 10.0f;
+static long long fileMaxBytes = 0;
+static double lastFileTime = 0.0;
+
+static MetricId Register(MetricKind kind, const char* name, const char* help, const char* labels, int& kindCount, int capacity)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const MetricInfo& metric : metrics) {
+        if (metric.kind == kind && metric.name == name && metric.labels == labels) return metric.slot;
+    }
+    if (kindCount >= capacity) {
+        TraceLog(LOG_WARNING, "METRICS: No room for %s{%s}, at most %d of its kind", name, labels, capacity);
+        return -1;
+    }
+    MetricInfo metric;
+    metric.kind = kind;
+    metric.slot = kindCount++;
+    metric.name = name;
+    metric.help = help;
+    metric.labels = labels;
+    metrics.push_back(metric);
+    return metric.slot;
+}
+
+MetricId MetricsCounter(const char* name, const char* help, const char* labels)
+{
+    return Register(METRIC_COUNTER, name, help, labels, counterCount, maxCounters);
+}
+
+MetricId MetricsGauge(const char* name, const char* help, const char* labels)
+{
+    return Register(METRIC_GAUGE, name, help, labels, gaugeCount, maxGauges);
+}
+
+MetricId MetricsHistogram(const char* name, const char* help, double resolution, const char* labels)
+{
+    MetricId id = Register(METRIC_HISTOGRAM, name, help, labels, histogramCount, maxHistograms);
+    if (id >= 0) {
+        histogramScale[id] = (resolution > 0.0) ? 1.0 / resolution : 1.0;
+    }
+    return id;
+}
+
+static MetricsShard& LocalShard()
+{
+    if (localShard == nullptr) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        localShard = new MetricsShard();
+        localShard->next = firstShard.load(std::memory_order_relaxed);
+        firstShard.store(localShard, std::memory_order_release);
+    }
+    return *localShard;
+}
+
+// Only the owning thread writes, so no read-modify-write is needed
+template <typename T>
+static void AddRelaxed(std::atomic<T>& value, T amount)
+{
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void MetricsAdd(MetricId counter, unsigned long long amount)
+{
+    if (counter < 0) return;
+    AddRelaxed(LocalShard().counters[counter], amount);
+}
+
+void MetricsSet(MetricId gauge, double value)
+{
+    if (gauge < 0) return;
+    gauges[gauge].store(value, std::memory_order_relaxed);
+}
+
+static int HighestBit(unsigned long long value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+static int BucketIndex(unsigned long long value)
+{
+    if (value < (unsigned long long)linearLimit) return (int)value;
+    // Keeps the top five bits, the mantissa is 16..31
+    int exponent = HighestBit(value) - 4;
+    if (exponent > maxExponent) return histogramBuckets - 1;
+    int mantissa = (int)(value >> exponent);
+    return linearLimit + (exponent - 1) * subBucketCount + (mantissa - subBucketCount);
+}
+
+// Upper bound of a bucket in recorded units, the values in it are below
+static double BucketLimit(int bucket)
+{
+    if (bucket < linearLimit) return bucket + 1.0;
+    int exponent = (bucket - linearLimit) / subBucketCount + 1;
+    int mantissa = (bucket - linearLimit) % subBucketCount + subBucketCount;
+    return (mantissa + 1.0) * (double)(1ULL << exponent);
+}
+
+void MetricsRecord(MetricId histogram, double value)
+{
+    if (histogram < 0) return;
+    HistogramShard& shard = LocalShard().histograms[histogram];
+
+    double scaled = value * histogramScale[histogram];
+    unsigned long long units = (scaled > 0.0) ? (unsigned long long)fmin(scaled, 1e15) : 0;
+    AddRelaxed(shard.buckets[BucketIndex(units)], 1u);
+    AddRelaxed(shard.sum, value);
+}
+
+static void AppendNumber(std::string& out, double value)
+{
+    if (std::isnan(value)) {
+        out += "NaN";
+        return;
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%.15g", value);
+    out += text;
+}
+
+static void AppendSample(std::string& out, const std::string& name, const char* suffix, const std::string& labels,
+    const char* extraLabel, double value, long long timestampMs)
+{
+    out += name;
+    out += suffix;
+    if (!labels.empty() || extraLabel != nullptr) {
+        out += '{';
+        out += labels;
+        if (extraLabel != nullptr) {
+            if (!labels.empty()) out += ',';
+            out += extraLabel;
+        }
+        out += '}';
+    }
+    out += ' ';
+    AppendNumber(out, value);
+    if (timestampMs != 0) {
+        out += ' ';
+        out += std::to_string(timestampMs);
+    }
+    out += '\n';
+}
+
+// Buckets are cumulative since start, so every collector (the file, each
+// scraper) gets its own window from the difference of two snapshots and no
+// export changes what the next one sees. Empty buckets are left out, once
+// written a bucket stays in every later snapshot
+static void AppendHistogram(std::string& out, const MetricInfo& metric, const std::vector<MetricsShard*>& shardList, long long timestampMs)
+{
+    std::vector<unsigned long long> totals(histogramBuckets, 0);
+    double sum = 0.0;
+    for (MetricsShard* shard : shardList) {
+        const HistogramShard& histogram = shard->histograms[metric.slot];
+        for (int i = 0; i < histogramBuckets; i++) {
+            totals[i] += histogram.buckets[i].load(std::memory_order_relaxed);
+        }
+        sum += histogram.sum.load(std::memory_order_relaxed);
+    }
+
+    double resolution = 1.0 / histogramScale[metric.slot];
+    unsigned long long count = 0;
+    for (int i = 0; i < histogramBuckets - 1; i++) {
+        if (totals[i] == 0) continue;
+        count += totals[i];
+        char label[48];
+        snprintf(label, sizeof(label), "le=\"%.6g\"", BucketLimit(i) * resolution);
+        AppendSample(out, metric.name, "_bucket", metric.labels, label, (double)count, timestampMs);
+    }
+    // The last bucket also holds everything past the range
+    count += totals[histogramBuckets - 1];
+    AppendSample(out, metric.name, "_bucket", metric.labels, "le=\"+Inf\"", (double)count, timestampMs);
+    AppendSample(out, metric.name, "_sum", metric.labels, nullptr, sum, timestampMs);
+    AppendSample(out, metric.name, "_count", metric.labels, nullptr, (double)count, timestampMs);
+}
+
+std::string MetricsToPrometheus(long long timestampMs)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<MetricsShard*> shardList;
+    for (MetricsShard* shard = firstShard.load(std::memory_order_acquire); shard != nullptr; shard = shard->next) {
+        shardList.push_back(shard);
+    }
+
+    static const char* typeNames[] = {"counter", "gauge", "histogram"};
+    std::string out;
+    out.reserve(16 * 1024);
+    for (size_t i = 0; i < metrics.size(); i++) {
+        // A family is written once, where its first metric was registered
+        bool written = false;
+        for (size_t k = 0; k < i && !written; k++) {
+            written = (metrics[k].name == metrics[i].name);
+        }
+        if (written) continue;
+
+        out += "# HELP " + metrics[i].name + " " + metrics[i].help + "\n";
+        out += "# TYPE " + metrics[i].name + " " + typeNames[metrics[i].kind] + "\n";
+        for (size_t j = i; j < metrics.size(); j++) {
+            const MetricInfo& metric = metrics[j];
+            if (metric.name != metrics[i].name) continue;
+
+            if (metric.kind == METRIC_COUNTER) {
+                unsigned long long total = 0;
+                for (MetricsShard* shard : shardList) {
+                    total += shard->counters[metric.slot].load(std::memory_order_relaxed);
+                }
+                AppendSample(out, metric.name, "", metric.labels, nullptr, (double)total, timestampMs);
+            } else if (metric.kind == METRIC_GAUGE) {
+                AppendSample(out, metric.name, "", metric.labels, nullptr, gauges[metric.slot].load(std::memory_order_relaxed), timestampMs);
+            } else {
+                AppendHistogram(out, metric, shardList, timestampMs);
+            }
+        }
+    }
+    return out;
+}
+
+#ifdef METRICS_UNIX_SOCKET
+
+static void CloseClient(MetricsClient& client)
+{
+    // Drain the request (if any, e.g. from curl) so closing doesn't reset the connection
+    char request[1024];
+    while (recv(client.fd, request, sizeof(request), MSG_DONTWAIT) > 0) {
+    }
+    shutdown(client.fd, SHUT_WR);
+    close(client.fd);
+}
+
+static void CloseSocket()
+{
+    for (MetricsClient& client : clients) {
+        CloseClient(client);
+    }
+    clients.clear();
+    if (listenSocket < 0) return;
+    close(listenSocket);
+    unlink(socketPath.c_str());
+    listenSocket = -1;
+}
+
+static void OpenSocket(const std::string& path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        TraceLog(LOG_WARNING, "METRICS: Socket path too long: %s", path.c_str());
+        return;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // A socket left behind by a previous run is replaced, anything else is not ours to delete
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            TraceLog(LOG_WARNING, "METRICS: %s exists and is not a socket", path.c_str());
+            return;
+        }
+        unlink(path.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        TraceLog(LOG_WARNING, "METRICS: Failed to create socket");
+        return;
+    }
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, 4) != 0) {
+        TraceLog(LOG_WARNING, "METRICS: Failed to listen on %s", path.c_str());
+        close(fd);
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    listenSocket = fd;
+    TraceLog(LOG_INFO, "METRICS: Serving on %s", path.c_str());
+}
+
+static void AddClient(int fd, const std::string& response, double now)
+{
+    if ((int)clients.size() >= maxClients) {
+        TraceLog(LOG_WARNING, "METRICS: %d scrapes still being sent, dropping a new one", maxClients);
+        close(fd);
+        return;
+    }
+    // Accepted sockets don't inherit O_NONBLOCK everywhere, a client that
+    // doesn't read must never block the frame
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+    MetricsClient client;
+    client.fd = fd;
+    client.response = response;
+    client.sent = 0;
+    client.acceptTime = now;
+    clients.push_back(client);
+}
+
+// Sends what each client's socket buffer takes without waiting, the rest on later frames
+static void SendToClients(double now)
+{
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+    const int flags = MSG_DONTWAIT;
+#endif
+    int kept = 0;
+    for (size_t i = 0; i < clients.size(); i++) {
+        MetricsClient& client = clients[i];
+        bool failed = false;
+        while (client.sent < client.response.size()) {
+            ssize_t result = send(client.fd, client.response.c_str() + client.sent, client.response.size() - client.sent, flags);
+            if (result <= 0) {
+                failed = (result == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR));
+                break;
+            }
+            client.sent += (size_t)result;
+        }
+        bool done = (client.sent == client.response.size());
+        if (!done && !failed && now - client.acceptTime < clientTimeout) {
+            if ((int)i != kept) {
+                clients[kept] = std::move(client);
+            }
+            kept++;
+            continue;
+        }
+        if (!done && !failed) {
+            TraceLog(LOG_WARNING, "METRICS: Dropping a scrape not read within %.0f s", clientTimeout);
+        }
+        CloseClient(client);
+    }
+    clients.resize(kept);
+}
+
+#endif
+
+void MetricsSetSocket(const std::string& path)
+{
+    if (path == socketPath) return;
+#ifdef METRICS_UNIX_SOCKET
+    CloseSocket();
+    socketPath = path;
+    if (!path.empty()) {
+        OpenSocket(path);
+    }
+#else
+    socketPath = path;
+    if (!path.empty()) {
+        TraceLog(LOG_INFO, "METRICS: Socket export is not available on this platform");
+    }
+#endif
+}
+
+void MetricsSetFile(const std::string& path, float intervalSeconds, long long maxBytes)
+{
+    if (path != filePath) {
+        lastFileTime = GetTime();
+        if (!path.empty()) {
+            TraceLog(LOG_INFO, "METRICS: Writing to %s every %.0f s", path.c_str(), intervalSeconds);
+        }
+    }
+    filePath = path;
+    fileInterval = intervalSeconds;
+    fileMaxBytes = maxBytes;
+}
+
+static void WriteFile()
+{
+    long long nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string snapshot = MetricsToPrometheus(nowMs);
+
+    FILE* file = fopen(filePath.c_str(), "ab");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "METRICS: Failed to open %s", filePath.c_str());
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    if (fileMaxBytes > 0 && size > 0 && size + (long long)snapshot.size() > fileMaxBytes) {
+        fclose(file);
+        std::string rotated = filePath + ".1";
+        remove(rotated.c_str());
+        rename(filePath.c_str(), rotated.c_str());
+        file = fopen(filePath.c_str(), "wb");
+        if (file == NULL) {
+            TraceLog(LOG_WARNING, "METRICS: Failed to open %s", filePath.c_str());
+            return;
+        }
+    }
+    fwrite(snapshot.c_str(), 1, snapshot.size(), file);
+    fclose(file);
+}
+
+void MetricsUpdate(const std::function<void()>& collect)
+{
+    double now = GetTime();
+    bool collected = false;
+
+#ifdef METRICS_UNIX_SOCKET
+    // One failed accept every acceptInterval is all this costs while nobody scrapes
+    if (listenSocket >= 0 && now - lastAcceptTime >= acceptInterval) {
+        lastAcceptTime = now;
+        std::string response;
+        for (;;) {
+            int client = accept(listenSocket, nullptr, nullptr);
+            if (client < 0) break;
+            if (!collected) {
+                collect();
+                collected = true;
+            }
+            // Clients waiting together get the same snapshot
+            if (response.empty()) {
+                response = httpHeader + MetricsToPrometheus();
+            }
+            AddClient(client, response, now);
+        }
+    }
+    if (!clients.empty()) {
+        SendToClients(now);
+    }
+#endif
+
+    if (!filePath.empty() && now - lastFileTime >= fileInterval) {
+        lastFileTime = now;
+        if (!collected) {
+            collect();
+        }
+        WriteFile();
+    }
+}
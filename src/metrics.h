@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <functional>
+
+// Runtime metrics for watching long runs from outside the game: counters,
+// gauges and histograms, exported in the Prometheus text format to whoever
+// connects to a Unix domain socket, and/or appended to a rotating file.
+//
+// Counters and histograms are recorded into a shard owned by the recording
+// thread with relaxed atomics, so recording takes no lock and threads don't
+// share cache lines. An export adds the shards up. Nothing is formatted
+// unless a collector connects or the file is due.
+
+// Index of a metric within its kind, -1 when registering failed. Recording
+// to -1 does nothing.
+typedef int MetricId;
+
+// Registering the same name and labels again returns the same metric.
+// labels are Prometheus label pairs without the braces, e.g. "system=\"agents\"".
+MetricId MetricsCounter(const char* name, const char* help, const char* labels = "");
+MetricId MetricsGauge(const char* name, const char* help, const char* labels = "");
+// resolution is the smallest value told apart. Buckets are resolution wide up to
+// 32 * resolution and at most 1/16 (6.25%) of their value wide above that
+MetricId MetricsHistogram(const char* name, const char* help, double resolution, const char* labels = "");
+
+void MetricsAdd(MetricId counter, unsigned long long amount = 1);
+void MetricsSet(MetricId gauge, double value);
+void MetricsRecord(MetricId histogram, double value);
+
+// Empty paths disable the export. The socket is desktop only (not Windows).
+void MetricsSetSocket(const std::string& path);
+// Appends a timestamped snapshot every interval, path is moved to path.1 when it would grow past maxBytes
+void MetricsSetFile(const std::string& path, float intervalSeconds, long long maxBytes);
+
+// Accepts pending socket connections, sends each scraper as much of its
+// snapshot as its socket takes without blocking (the rest on later frames)
+// and writes the file when due, call once per frame. collect runs right before an export, to set gauges that are
+// not worth keeping current every frame.
+void MetricsUpdate(const std::function<void()>& collect);
+
+// Histograms are exported with cumulative buckets, quantiles over a window
+// come from two snapshots, e.g. histogram_quantile(0.99, rate(x_bucket[1m])).
+// Exporting changes no state. timestampMs 0 leaves out timestamps.
+std::string MetricsToPrometheus(long long timestampMs = 0);
@@ -0,0 +1,368 @@
+#include <vector>
+#include <cstring>
+#include "raylib.h"
+#include "renderqueue.h"
+#include "memtrack.h"
+
+// rlgl limits used to estimate batch flushes, these match raylib's defaults
+#if defined(PLATFORM_WEB)
+static const int batchVertexLimit = 2048 * 4;
+#else
+static const int batchVertexLimit = 8192 * 4;
+#endif
+static const int batchDrawCallLimit = 256;
+static const int circleSegments = 36;
+static const int fontCapacity = 8;
+
+RenderQueue::RenderQueue(int capacity, int textCapacity)
+{
+    MemTagScope memTag(MEMTAG_RENDER);
+    commands.resize(capacity);
+    keys.resize(capacity);
+    for (int i = 0; i < 2; i++) {
+        sortKeys[i].resize(capacity);
+        order[i].resize(capacity);
+    }
+    textBuffer.resize(textCapacity);
+    fonts.resize(fontCapacity);
+}
+
+void RenderQueue::Begin(Camera2D camera)
+{
+    this->camera = camera;
+    count = 0;
+    lastCommand = -1;
+    lateLatchCommand = -1;
+    textUsed = 0;
+    fontCount = 0;
+    sortedBuffer = 0;
+    stats = RenderStats();
+    shapesTextureId = GetShapesTexture().id;
+}
+
+RenderQueue::Command* RenderQueue::Push(int layer, unsigned int textureId)
+{
+    if (count >= (int)commands.size()) {
+        if (stats.dropped == 0) {
+            TraceLog(LOG_WARNING, "RENDER: Command buffer full (%d commands), dropping draws", (int)commands.size());
+        }
+        stats.dropped++;
+        lastCommand = -1;
+        return nullptr;
+    }
+
+    // Layer in the top byte so it dominates. Below it the texture id groups
+    // commands by material where overlaps don't matter, elsewhere the
+    // recording index keeps them in order (the capacity is below 2^24)
+    bool groupByTexture = layer < 32 && (orderIndependentLayers & (1u << layer)) != 0;
+    unsigned int minorKey = groupByTexture ? textureId : (unsigned int)count;
+    keys[count] = ((unsigned int)(layer & 0xFF) << 24) | (minorKey & 0xFFFFFF);
+    Command* command = &commands[count];
+    command->layer = (unsigned char)layer;
+    command->textureId = textureId;
+    lastCommand = count;
+    count++;
+    return command;
+}
+
+int RenderQueue::StoreText(const char* text)
+{
+    int length = (int)strlen(text) + 1;
+    if (textUsed + length > (int)textBuffer.size()) {
+        return -1;
+    }
+    memcpy(&textBuffer[textUsed], text, length);
+    int offset = textUsed;
+    textUsed += length;
+    return offset;
+}
+
+int RenderQueue::StoreFont(const Font& font)
+{
+    for (int i = 0; i < fontCount; i++) {
+        if (fonts[i].texture.id == font.texture.id && fonts[i].glyphs == font.glyphs) {
+            return i;
+        }
+    }
+    if (fontCount >= (int)fonts.size()) {
+        return -1;
+    }
+    fonts[fontCount] = font;
+    return fontCount++;
+}
+
+void RenderQueue::AddCircle(int layer, Vector2 center, float radius, Color color)
+{
+    Command* command = Push(layer, shapesTextureId);
+    if (command == nullptr) return;
+    command->type = CMD_CIRCLE;
+    command->color = color;
+    command->rect = {center.x, center.y, radius, radius};
+}
+
+void RenderQueue::AddRectangle(int layer, Rectangle rect, Color color)
+{
+    Command* command = Push(layer, shapesTextureId);
+    if (command == nullptr) return;
+    command->type = CMD_RECTANGLE;
+    command->color = color;
+    command->rect = rect;
+}
+
+void RenderQueue::AddRectangleRounded(int layer, Rectangle rect, float roundness, int segments, Color color)
+{
+    Command* command = Push(layer, shapesTextureId);
+    if (command == nullptr) return;
+    command->type = CMD_RECTANGLE_ROUNDED;
+    command->color = color;
+    command->rect = rect;
+    command->source = {roundness, (float)segments, 0, 0};
+}
+
+void RenderQueue::AddRectangleLines(int layer, Rectangle rect, float thickness, Color color)
+{
+    Command* command = Push(layer, shapesTextureId);
+    if (command == nullptr) return;
+    command->type = CMD_RECTANGLE_LINES;
+    command->color = color;
+    command->rect = rect;
+    command->source = {thickness, 0, 0, 0};
+}
+
+void RenderQueue::AddTexture(int layer, Texture2D texture, Rectangle source, Rectangle dest, Color color)
+{
+    Command* command = Push(layer, texture.id);
+    if (command == nullptr) return;
+    command->type = CMD_TEXTURE;
+    command->color = color;
+    command->texture = texture;
+    command->source = source;
+    command->rect = dest;
+}
+
+void RenderQueue::AddSprite(int layer, const Sprite& sprite, Rectangle dest, Color tint)
+{
+    AddTexture(layer, sprite.texture, sprite.source, dest, tint);
+}
+
+void RenderQueue::AddText(int layer, const char* text, int x, int y, int fontSize, Color color)
+{
+    // Same spacing rule as DrawText
+    const int defaultFontSize = 10;
+    if (fontSize < defaultFontSize) fontSize = defaultFontSize;
+    AddTextEx(layer, GetFontDefault(), text, {(float)x, (float)y}, (float)fontSize, (float)(fontSize / defaultFontSize), color);
+}
+
+void RenderQueue::AddTextEx(int layer, const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color color)
+{
+    int textOffset = StoreText(text);
+    int fontIndex = StoreFont(font);
+    if (textOffset < 0 || fontIndex < 0) {
+        stats.dropped++;
+        return;
+    }
+    Command* command = Push(layer, font.texture.id);
+    if (command == nullptr) return;
+    command->type = CMD_TEXT;
+    command->color = color;
+    command->rect = {position.x, position.y, 0, 0};
+    command->fontIndex = fontIndex;
+    command->textOffset = textOffset;
+    command->fontSize = fontSize;
+    command->spacing = spacing;
+}
+
+void RenderQueue::MarkLateLatched()
+{
+    lateLatchCommand = lastCommand;
+}
+
+void RenderQueue::LatchPosition(Vector2 position)
+{
+    if (lateLatchCommand < 0) return;
+    // Only the position changes, so the sorted order stays valid
+    Command& command = commands[lateLatchCommand];
+    command.rect.x = position.x;
+    command.rect.y = position.y;
+}
+
+void RenderQueue::Sort()
+{
+    // LSD radix sort of command indices, 8 bits per pass. Stable, so commands
+    // with the same layer and texture keep their recording order.
+    int src = 0;
+    for (int i = 0; i < count; i++) {
+        sortKeys[0][i] = keys[i];
+        order[0][i] = i;
+    }
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        int histogram[256] = {0};
+        for (int i = 0; i < count; i++) {
+            histogram[(sortKeys[src][i] >> shift) & 0xFF]++;
+        }
+        // All keys share this byte, the pass would not change anything
+        if (histogram[(sortKeys[src][0] >> shift) & 0xFF] == count) continue;
+
+        int offset = 0;
+        for (int b = 0; b < 256; b++) {
+            int bucketSize = histogram[b];
+            histogram[b] = offset;
+            offset += bucketSize;
+        }
+
+        int dst = 1 - src;
+        for (int i = 0; i < count; i++) {
+            unsigned int key = sortKeys[src][i];
+            int position = histogram[(key >> shift) & 0xFF]++;
+            sortKeys[dst][position] = key;
+            order[dst][position] = order[src][i];
+        }
+        src = dst;
+    }
+    sortedBuffer = src;
+}
+
+void RenderQueue::Submit()
+{
+    // Texture switches are counted from the textures submitted, the queue never
+    // changes shaders. rlgl does not report its flushes, so they are estimated
+    // from what is known to force one: entering or leaving 2D mode, too many
+    // draw calls or too many vertices in a batch, and the final flush at the
+    // end of the frame.
+    unsigned int currentTexture = 0;
+    int batchDrawCalls = 0;
+    int batchVertices = 0;
+    bool inWorldSpace = false;
+    stats.commands = count;
+
+    for (int i = 0; i < count; i++) {
+        const Command& command = commands[order[sortedBuffer][i]];
+        unsigned int textureId = command.textureId;
+
+        bool worldLayer = command.layer < LAYER_SCREEN;
+        if (worldLayer != inWorldSpace) {
+            if (worldLayer) BeginMode2D(camera);
+            else EndMode2D();
+            inWorldSpace = worldLayer;
+            stats.estimatedFlushes++;
+            batchDrawCalls = 0;
+            batchVertices = 0;
+        }
+
+        if (textureId != currentTexture) {
+            stats.textureSwitches++;
+            currentTexture = textureId;
+            if (++batchDrawCalls >= batchDrawCallLimit) {
+                stats.estimatedFlushes++;
+                batchDrawCalls = 0;
+                batchVertices = 0;
+            }
+        }
+
+        int vertices = 4;
+        switch (command.type)
+        {
+            case CMD_CIRCLE:
+                DrawCircleV({command.rect.x, command.rect.y}, command.rect.width, command.color);
+                vertices = circleSegments * 3;
+                break;
+            case CMD_RECTANGLE:
+                DrawRectangleRec(command.rect, command.color);
+                break;
+            case CMD_RECTANGLE_ROUNDED:
+                DrawRectangleRounded(command.rect, command.source.x, (int)command.source.y, command.color);
+                vertices = ((int)command.source.y * 4 + 5) * 6;
+                break;
+            case CMD_RECTANGLE_LINES:
+                DrawRectangleLinesEx(command.rect, command.source.x, command.color);
+                vertices = 4 * 4;
+                break;
+            case CMD_TEXTURE:
+                DrawTexturePro(command.texture, command.source, command.rect, {0, 0}, 0.0f, command.color);
+                break;
+            case CMD_TEXT:
+            {
+                const char* text = &textBuffer[command.textOffset];
+                DrawTextEx(fonts[command.fontIndex], text, {command.rect.x, command.rect.y}, command.fontSize, command.spacing, command.color);
+                vertices = (int)strlen(text) * 4;
+                break;
+            }
+        }
+
+        batchVertices += vertices;
+        if (batchVertices >= batchVertexLimit) {
+            stats.estimatedFlushes++;
+            batchVertices = 0;
+            batchDrawCalls = 0;
+        }
+    }
+
+    if (inWorldSpace) {
+        EndMode2D();
+    }
+    stats.estimatedFlushes++;
+}
+
+#ifndef __EMSCRIPTEN__
+
+RenderWorker::RenderWorker()
+{
+    thread = std::thread(&RenderWorker::ThreadMain, this);
+}
+
+RenderWorker::~RenderWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void RenderWorker::Run(const std::function<void()>& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = job;
+        hasJob = true;
+    }
+    wake.notify_one();
+}
+
+void RenderWorker::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return !hasJob; });
+}
+
+void RenderWorker::ThreadMain()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return hasJob || quit; });
+        if (quit) return;
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        hasJob = false;
+        finished.notify_one();
+    }
+}
+
+#else
+
+RenderWorker::RenderWorker() {}
+RenderWorker::~RenderWorker() {}
+
+void RenderWorker::Run(const std::function<void()>& job)
+{
+    job();
+}
+
+void RenderWorker::Wait() {}
+
+#endif
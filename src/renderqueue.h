@@ -0,0 +1,152 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "raylib.h"
+#include "spriteatlas.h"
+
+// Draw order is decided by layer first. Within a layer commands are drawn in
+// the order they were recorded, except on order independent layers, where they
+// are grouped by texture. Layers below LAYER_SCREEN are drawn in world space
+// through the queue's camera.
+enum RenderLayer
+{
+    LAYER_TILES = 0,
+    LAYER_PROPS = 1,
+    LAYER_PLAYER = 2,
+    LAYER_WORLD_OVERLAY = 3,
+    LAYER_SCREEN = 8,
+    LAYER_HUD_BACKGROUND = 8,
+    LAYER_HUD = 9,
+    LAYER_UI_BACKGROUND = 10,
+    LAYER_UI = 11
+};
+
+// Layers whose draws never overlap, so grouping them by texture cannot change
+// the picture: tile chunks each cover their own square of the world. Props,
+// agents and everything on screen overlap and keep their recording order.
+const unsigned int orderIndependentLayers = 1u << LAYER_TILES;
+
+struct RenderStats
+{
+    int commands = 0;
+    int dropped = 0;        // Commands that did not fit in the preallocated buffer
+    int textureSwitches = 0;    // Counted while submitting, each one starts a new rlgl draw call
+    int estimatedFlushes = 0;   // Not counted by rlgl, estimated in RenderQueue::Submit
+};
+
+// Preallocated buffer of draw commands. Game code records commands layer by
+// layer in any order, Sort orders them by layer with a radix sort (by texture
+// within order independent layers), and Submit issues the raylib draw calls.
+// Recording does not touch GL, so it may run on another thread.
+class RenderQueue
+{
+public:
+    RenderQueue(int capacity = 8192, int textCapacity = 64 * 1024);
+
+    void Begin(Camera2D camera);
+
+    void AddCircle(int layer, Vector2 center, float radius, Color color);
+    void AddRectangle(int layer, Rectangle rect, Color color);
+    void AddRectangleRounded(int layer, Rectangle rect, float roundness, int segments, Color color);
+    void AddRectangleLines(int layer, Rectangle rect, float thickness, Color color);
+    void AddTexture(int layer, Texture2D texture, Rectangle source, Rectangle dest, Color color);
+    void AddSprite(int layer, const Sprite& sprite, Rectangle dest, Color tint);
+    // Text with the default font, same parameters as DrawText
+    void AddText(int layer, const char* text, int x, int y, int fontSize, Color color);
+    void AddTextEx(int layer, const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color color);
+
+    // Marks the last added command to be moved by LatchPosition, for drawing
+    // the player where it is at submit time rather than when it was recorded
+    void MarkLateLatched();
+    // Moves the marked command to position (circle centre, otherwise top left corner)
+    void LatchPosition(Vector2 position);
+    // Replaces the camera the world layers were recorded with, the recorded
+    // commands have to cover the view of the new camera
+    void LatchCamera(Camera2D camera) { this->camera = camera; }
+
+    void Sort();
+    // Must be called between BeginDrawing/EndDrawing or inside a texture mode
+    void Submit();
+
+    const RenderStats& GetStats() const { return stats; }
+
+private:
+    enum CommandType
+    {
+        CMD_CIRCLE,
+        CMD_RECTANGLE,
+        CMD_RECTANGLE_ROUNDED,
+        CMD_RECTANGLE_LINES,
+        CMD_TEXTURE,
+        CMD_TEXT
+    };
+
+    struct Command
+    {
+        unsigned char type;
+        unsigned char layer;
+        Color color;
+        unsigned int textureId;
+        Rectangle rect;         // Circle uses x, y as center and width as radius
+        Rectangle source;       // Texture source, rounded rectangle uses x as roundness and y as segments, lines use x as thickness
+        Texture2D texture;      // Texture for CMD_TEXTURE
+        int fontIndex;          // Into fonts
+        int textOffset;         // Into textBuffer
+        float fontSize;
+        float spacing;
+    };
+
+    Command* Push(int layer, unsigned int textureId);
+    int StoreText(const char* text);
+    int StoreFont(const Font& font);
+
+    std::vector<Command> commands;
+    std::vector<unsigned int> keys;
+    std::vector<unsigned int> sortKeys[2];
+    std::vector<int> order[2];
+    std::vector<char> textBuffer;
+    std::vector<Font> fonts;    // Copied once per frame, callers often pass a temporary such as GetFontDefault()
+    int count = 0;
+    int lastCommand = -1;       // Index of the last Push, -1 when it was dropped
+    int lateLatchCommand = -1;
+    int textUsed = 0;
+    int fontCount = 0;
+    int sortedBuffer = 0;
+    unsigned int shapesTextureId = 0;
+    Camera2D camera = {};
+    RenderStats stats;
+};
+
+// Frames a texture has to outlive its last use in a recorded queue. With
+// threaded recording a queue is submitted one frame after it was recorded.
+const int renderReleaseDelayFrames = 2;
+
+// Runs one job at a time on a persistent thread, used to record the next
+// frame's commands while the previous frame is submitted. Runs the job inline
+// on platforms without threads.
+class RenderWorker
+{
+public:
+    RenderWorker();
+    ~RenderWorker();
+
+    void Run(const std::function<void()>& job);
+    void Wait();
+
+private:
+#ifndef __EMSCRIPTEN__
+    void ThreadMain();
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool hasJob = false;
+    bool quit = false;
+#endif
+    std::function<void()> job;
+};
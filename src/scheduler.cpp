@@ -0,0 +1,190 @@
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "scheduler.h"
+
+SystemScheduler::SystemScheduler(int workerCount)
+{
+#ifndef __EMSCRIPTEN__
+    if (workerCount <= 0) {
+        int hardwareThreads = (int)std::thread::hardware_concurrency();
+        workerCount = std::min(std::max(hardwareThreads - 1, 0), 3);
+    }
+    this->workerCount = workerCount;
+    for (int i = 0; i < workerCount; i++) {
+        workers.push_back(std::thread(&SystemScheduler::ThreadMain, this, i + 1));
+    }
+#else
+    (void)workerCount;
+#endif
+}
+
+SystemScheduler::~SystemScheduler()
+{
+#ifndef __EMSCRIPTEN__
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    changed.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+#endif
+}
+
+void SystemScheduler::AddSystem(const char* name, ResourceMask reads, ResourceMask writes, bool mainThread, const std::function<void()>& run)
+{
+    System system;
+    system.run = run;
+    system.reads = reads;
+    system.writes = writes;
+    system.mainThread = mainThread;
+    system.stats.name = name;
+    systems.push_back(system);
+    graphDirty = true;
+}
+
+void SystemScheduler::BuildGraph()
+{
+    // An edge from every earlier system that conflicts, so conflicting systems
+    // keep the order they were added in and the graph can't have cycles
+    for (System& system : systems) {
+        system.successors.clear();
+        system.dependencyCount = 0;
+    }
+    for (int later = 0; later < (int)systems.size(); later++) {
+        System& b = systems[later];
+        for (int earlier = 0; earlier < later; earlier++) {
+            System& a = systems[earlier];
+            bool conflict = (a.writes & (b.reads | b.writes)) != 0 || (a.reads & b.writes) != 0;
+            if (conflict) {
+                a.successors.push_back(later);
+                b.dependencyCount++;
+            }
+        }
+    }
+    graphDirty = false;
+}
+
+void SystemScheduler::Execute(int index, int thread)
+{
+    System& system = systems[index];
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    system.run();
+    float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    SystemStats& stats = system.stats;
+    stats.lastMs = elapsedMs;
+    stats.averageMs = (tick == 0) ? elapsedMs : stats.averageMs + (elapsedMs - stats.averageMs) * 0.05f;
+    stats.thread = thread;
+    system.windowPeakMs = std::max(system.windowPeakMs, elapsedMs);
+}
+
+void SystemScheduler::Run()
+{
+    if (graphDirty) {
+        BuildGraph();
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#ifndef __EMSCRIPTEN__
+    if (!IsSerial()) {
+        RunParallel();
+    } else
+#endif
+    {
+        for (int i = 0; i < (int)systems.size(); i++) {
+            Execute(i, 0);
+        }
+    }
+    lastTickMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    tick++;
+    if (tick % statsWindow == 0) {
+        for (System& system : systems) {
+            system.stats.peakMs = system.windowPeakMs;
+            system.windowPeakMs = 0.0f;
+        }
+    }
+}
+
+#ifndef __EMSCRIPTEN__
+
+void SystemScheduler::RunParallel()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    mainReady.reserve(systems.size());
+    anyReady.reserve(systems.size());
+    for (int i = 0; i < (int)systems.size(); i++) {
+        systems[i].remaining = systems[i].dependencyCount;
+        if (systems[i].remaining == 0) {
+            MakeReady(i);
+        }
+    }
+    unfinished = (int)systems.size();
+    changed.notify_all();
+
+    // The calling thread runs the main thread systems and helps with the rest
+    while (unfinished > 0) {
+        int system = PopReady(mainReady);
+        if (system < 0) {
+            system = PopReady(anyReady);
+        }
+        if (system < 0) {
+            changed.wait(lock);
+            continue;
+        }
+        lock.unlock();
+        Execute(system, 0);
+        lock.lock();
+        Finish(system);
+    }
+}
+
+void SystemScheduler::ThreadMain(int thread)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        changed.wait(lock, [this] { return quit || !anyReady.empty(); });
+        if (quit) return;
+
+        int system = PopReady(anyReady);
+        lock.unlock();
+        Execute(system, thread);
+        lock.lock();
+        Finish(system);
+    }
+}
+
+void SystemScheduler::MakeReady(int system)
+{
+    if (systems[system].mainThread) {
+        mainReady.push_back(system);
+    } else {
+        anyReady.push_back(system);
+    }
+}
+
+int SystemScheduler::PopReady(std::vector<int>& ready)
+{
+    if (ready.empty()) return -1;
+    // Earliest added first, that is the serial order
+    std::vector<int>::iterator first = std::min_element(ready.begin(), ready.end());
+    int system = *first;
+    ready.erase(first);
+    return system;
+}
+
+void SystemScheduler::Finish(int system)
+{
+    for (int successor : systems[system].successors) {
+        if (--systems[successor].remaining == 0) {
+            MakeReady(successor);
+        }
+    }
+    unfinished--;
+    changed.notify_all();
+}
+
+#endif
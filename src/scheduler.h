@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Resources a system reads or writes, one bit each. What a bit stands for is
+// up to the code adding the systems.
+typedef unsigned int ResourceMask;
+
+struct SystemStats
+{
+    const char* name = "";
+    float lastMs = 0.0f;
+    float averageMs = 0.0f;
+    float peakMs = 0.0f;    // Highest over the last statsWindow ticks
+    int thread = 0;         // 0 is the thread calling Run, workers count from 1
+};
+
+// Runs the per tick systems of the game. Each system declares the resources
+// it reads and writes. When two systems write the same resource, or one
+// writes what the other reads, they run in the order they were added;
+// everything else may run at the same time on a pool of worker threads, so
+// the result does not depend on the thread timing. Systems that call into
+// the window, GL or anything else tied to the main thread are added with
+// mainThread and always run on the thread calling Run.
+class SystemScheduler
+{
+public:
+    // workerCount 0 picks one less than the hardware threads, up to 3
+    explicit SystemScheduler(int workerCount = 0);
+    ~SystemScheduler();
+
+    void AddSystem(const char* name, ResourceMask reads, ResourceMask writes, bool mainThread, const std::function<void()>& run);
+    // Runs every system once
+    void Run();
+
+    // Serial mode runs the systems one after another on the calling thread in
+    // the order they were added, for debugging and comparing timings
+    void SetSerial(bool serial) { this->serial = serial; }
+    bool IsSerial() const { return serial || workerCount == 0; }
+    int GetWorkerCount() const { return workerCount; }
+
+    int GetSystemCount() const { return (int)systems.size(); }
+    const SystemStats& GetStats(int system) const { return systems[system].stats; }
+    float GetLastTickMs() const { return lastTickMs; }
+
+private:
+    struct System
+    {
+        std::function<void()> run;
+        ResourceMask reads = 0;
+        ResourceMask writes = 0;
+        bool mainThread = false;
+        std::vector<int> successors;    // Systems that wait for this one
+        int dependencyCount = 0;
+        int remaining = 0;              // Dependencies not finished yet this tick
+        float windowPeakMs = 0.0f;
+        SystemStats stats;
+    };
+
+    static const int statsWindow = 144;
+
+    void BuildGraph();
+    void Execute(int system, int thread);
+
+    std::vector<System> systems;
+    bool graphDirty = false;
+    bool serial = false;
+    int workerCount = 0;
+    int tick = 0;
+    float lastTickMs = 0.0f;
+
+#ifndef __EMSCRIPTEN__
+    void RunParallel();
+    void ThreadMain(int thread);
+    // Called with mutex held
+    void MakeReady(int system);
+    int PopReady(std::vector<int>& ready);
+    void Finish(int system);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<int> mainReady;     // Ready systems only the calling thread may run
+    std::vector<int> anyReady;      // Ready systems for any thread
+    int unfinished = 0;
+    bool quit = false;
+#endif
+};
@@ -0,0 +1,69 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "raylib.h"
+#include "globals.h"
+#include "spatialgrid.h"
+
+void SpatialGrid::Init(float worldWidth, float worldHeight, float cellSize)
+{
+    this->cellSize = cellSize;
+    columns = MAX(1, (int)ceilf(worldWidth / cellSize));
+    rows = MAX(1, (int)ceilf(worldHeight / cellSize));
+    cells.assign(columns * rows, std::vector<int>());
+    queryStamps.clear();
+    queryCounter = 0;
+}
+
+void SpatialGrid::Clear()
+{
+    for (std::vector<int>& cell : cells) {
+        cell.clear();
+    }
+}
+
+void SpatialGrid::CellRange(Rectangle area, int& minX, int& minY, int& maxX, int& maxY) const
+{
+    minX = MAX(0, (int)floorf(area.x / cellSize));
+    minY = MAX(0, (int)floorf(area.y / cellSize));
+    maxX = MIN(columns - 1, (int)floorf((area.x + area.width) / cellSize));
+    maxY = MIN(rows - 1, (int)floorf((area.y + area.height) / cellSize));
+}
+
+void SpatialGrid::Insert(int id, Rectangle bounds)
+{
+    if (id >= (int)queryStamps.size()) {
+        queryStamps.resize(id + 1, 0);
+    }
+
+    int minX, minY, maxX, maxY;
+    CellRange(bounds, minX, minY, maxX, maxY);
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            cells[y * columns + x].push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::Query(Rectangle area, std::vector<int>& results)
+{
+    queryCounter++;
+    if (queryCounter == 0) {
+        // Wrapped around, old stamps could now collide with the counter
+        std::fill(queryStamps.begin(), queryStamps.end(), 0);
+        queryCounter = 1;
+    }
+
+    int minX, minY, maxX, maxY;
+    CellRange(area, minX, minY, maxX, maxY);
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            for (int id : cells[y * columns + x]) {
+                if (queryStamps[id] != queryCounter) {
+                    queryStamps[id] = queryCounter;
+                    results.push_back(id);
+                }
+            }
+        }
+    }
+}
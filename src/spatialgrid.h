@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+
+// Uniform grid over the world for finding the objects that overlap a rectangle.
+// Objects are referenced by id, an object spanning several cells is stored in each.
+class SpatialGrid
+{
+public:
+    void Init(float worldWidth, float worldHeight, float cellSize);
+    void Clear();
+    void Insert(int id, Rectangle bounds);
+    // Appends the ids of all objects whose cells overlap area, each id once
+    void Query(Rectangle area, std::vector<int>& results);
+
+private:
+    void CellRange(Rectangle area, int& minX, int& minY, int& maxX, int& maxY) const;
+
+    float cellSize = 1.0f;
+    int columns = 0;
+    int rows = 0;
+    std::vector<std::vector<int>> cells;
+    std::vector<unsigned int> queryStamps;  // Per id, last query that returned it
+    unsigned int queryCounter = 0;
+};
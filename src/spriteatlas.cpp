@@ -0,0 +1,158 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include "raylib.h"
+#include "spriteatlas.h"
+#include "renderqueue.h"
+#include "memtrack.h"
+
+SpriteAtlas::~SpriteAtlas()
+{
+    Unload();
+}
+
+bool SpriteAtlas::Load(const char* indexPath)
+{
+    AtlasData data;
+    return Decode(indexPath, data) && Upload(data);
+}
+
+bool SpriteAtlas::Decode(const char* indexPath, AtlasData& data)
+{
+    MemTagScope memTag(MEMTAG_RENDER);
+    std::string error;
+    if (!ReadAtlasIndex(indexPath, data.index, error)) {
+        TraceLog(LOG_WARNING, "ATLAS: %s", error.c_str());
+        return false;
+    }
+
+    // Every page has to load, a half written atlas must not break the game
+    std::string directory = GetDirectoryPath(indexPath);
+    for (const std::string& page : data.index.pages) {
+        std::string pagePath = directory + "/" + page;
+        Image image = LoadImage(pagePath.c_str());
+        if (image.data == NULL) {
+            TraceLog(LOG_WARNING, "ATLAS: Failed to load page %s", pagePath.c_str());
+            for (Image& loaded : data.pages) {
+                UnloadImage(loaded);
+            }
+            data.pages.clear();
+            return false;
+        }
+        data.pages.push_back(image);
+    }
+    return true;
+}
+
+bool SpriteAtlas::Upload(AtlasData& data)
+{
+    MemTagScope memTag(MEMTAG_RENDER);
+    std::vector<Texture2D> newPages;
+    for (const Image& image : data.pages) {
+        Texture2D texture = LoadTextureFromImage(image);
+        if (texture.id == 0) break;
+        // Sprites are scaled, the packer extrudes their borders so filtering stays inside each region
+        SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+        newPages.push_back(texture);
+    }
+    for (Image& image : data.pages) {
+        UnloadImage(image);
+    }
+    if (newPages.size() != data.pages.size()) {
+        TraceLog(LOG_WARNING, "ATLAS: Failed to upload page %d", (int)newPages.size());
+        for (Texture2D& loaded : newPages) {
+            UnloadTexture(loaded);
+        }
+        data.pages.clear();
+        return false;
+    }
+    data.pages.clear();
+
+    ResetShapesTexture();
+    for (const Texture2D& page : pages) {
+        retiredPages.push_back(RetiredPage{page, renderReleaseDelayFrames});
+    }
+    index = data.index;
+    pages = newPages;
+    for (const Texture2D& page : pages) {
+        MemTrackGpu(MEMTAG_RENDER, MemTextureBytes(page));
+    }
+    TraceLog(LOG_INFO, "ATLAS: Loaded %d sprites on %d pages", (int)index.sprites.size(), (int)pages.size());
+    return true;
+}
+
+void SpriteAtlas::Unload()
+{
+    ResetShapesTexture();
+    for (Texture2D& page : pages) {
+        ReleasePage(page);
+    }
+    for (RetiredPage& retired : retiredPages) {
+        ReleasePage(retired.texture);
+    }
+    pages.clear();
+    retiredPages.clear();
+    index = AtlasIndex();
+}
+
+void SpriteAtlas::Update()
+{
+    int kept = 0;
+    for (RetiredPage& retired : retiredPages) {
+        if (retired.framesLeft-- > 0) {
+            retiredPages[kept++] = retired;
+            continue;
+        }
+        ReleasePage(retired.texture);
+    }
+    retiredPages.resize(kept);
+}
+
+void SpriteAtlas::ResetShapesTexture() const
+{
+    for (const Texture2D& page : pages) {
+        if (GetShapesTexture().id == page.id) {
+            SetShapesTexture(Texture2D{}, Rectangle{});
+        }
+    }
+}
+
+void SpriteAtlas::ReleasePage(Texture2D& page)
+{
+    MemTagScope memTag(MEMTAG_RENDER);
+    MemTrackGpu(MEMTAG_RENDER, -MemTextureBytes(page));
+    UnloadTexture(page);
+}
+
+Sprite SpriteAtlas::GetSprite(const char* name) const
+{
+    // Sprites are sorted by name in the index
+    int low = 0;
+    int high = (int)index.sprites.size() - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        const AtlasSpriteEntry& entry = index.sprites[middle];
+        int order = strcmp(entry.name.c_str(), name);
+        if (order == 0) {
+            Sprite sprite;
+            sprite.texture = pages[entry.page];
+            sprite.source = {(float)entry.x, (float)entry.y, (float)entry.width, (float)entry.height};
+            return sprite;
+        }
+        if (order < 0) low = middle + 1;
+        else high = middle - 1;
+    }
+
+    if (!pages.empty()) {
+        TraceLog(LOG_WARNING, "ATLAS: No sprite named %s", name);
+    }
+    return Sprite();
+}
+
+void SpriteAtlas::UseForShapes() const
+{
+    Sprite white = GetSprite(atlasWhiteSprite);
+    if (!white.IsValid()) return;
+    // Inset so bilinear filtering only ever samples white pixels
+    SetShapesTexture(white.texture, {white.source.x + 1, white.source.y + 1, white.source.width - 2, white.source.height - 2});
+}
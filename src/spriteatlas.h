@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "raylib.h"
+#include "atlasformat.h"
+
+// A region of an atlas page. Sprites are plain values, drawing any number of
+// sprites from the same page keeps them in one texture batch.
+struct Sprite
+{
+    Texture2D texture = {};
+    Rectangle source = {};
+
+    bool IsValid() const { return texture.id != 0; }
+    float Width() const { return source.width; }
+    float Height() const { return source.height; }
+};
+
+// Index and decoded page images of an atlas, read without touching GL
+struct AtlasData
+{
+    AtlasIndex index;
+    std::vector<Image> pages;
+};
+
+// Sprite atlas built by the atlas_pack tool (see CMakeLists.txt), one texture
+// per page and a sorted name index
+class SpriteAtlas
+{
+public:
+    ~SpriteAtlas();
+
+    // The pages of an atlas loaded before are released a few frames later by
+    // Update, a recorded frame may still draw from them
+    bool Load(const char* indexPath);
+    // Load split in two: Decode reads the index and page images and may run on
+    // any thread, Upload creates the textures and takes over the atlas
+    static bool Decode(const char* indexPath, AtlasData& data);
+    bool Upload(AtlasData& data);
+    void Unload();
+    // Releases replaced pages no recorded frame can use anymore, call once per frame
+    void Update();
+
+    // Looks the sprite up by name, an invalid sprite if it isn't in the atlas.
+    // Look sprites up once when loading, not per draw.
+    Sprite GetSprite(const char* name) const;
+    int GetPageCount() const { return (int)pages.size(); }
+    int GetSpriteCount() const { return (int)index.sprites.size(); }
+
+    // Makes raylib draw shapes from the atlas' white region, so shapes and
+    // sprites on the same page don't switch textures. Undone by Unload.
+    void UseForShapes() const;
+
+private:
+    struct RetiredPage
+    {
+        Texture2D texture;
+        int framesLeft;
+    };
+
+    // Stops shapes from drawing with pages that are about to go away
+    void ResetShapesTexture() const;
+    void ReleasePage(Texture2D& page);
+
+    AtlasIndex index;
+    std::vector<Texture2D> pages;
+    std::vector<RetiredPage> retiredPages;
+};
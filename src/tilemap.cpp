@@ -0,0 +1,255 @@
+#include <vector>
+#include <string>
+#include <cstring>
+#include <utility>
+#include "raylib.h"
+#include "tilemap.h"
+#include "memtrack.h"
+
+// Tile ids used by the level files
+enum TileType
+{
+    TILE_GRASS = 0,
+    TILE_DIRT = 1,
+    TILE_SAND = 2,
+    TILE_WATER = 3,
+    TILE_STONE = 4,
+    TILE_TYPE_COUNT
+};
+
+static const Color tileColors[TILE_TYPE_COUNT] = {
+    {86, 148, 70, 255},     // Grass
+    {134, 100, 66, 255},    // Dirt
+    {214, 196, 140, 255},   // Sand
+    {52, 104, 170, 255},    // Water
+    {96, 96, 104, 255},     // Stone
+};
+
+// Chunks this far outside the view (in chunks) are prebuilt, twice as far they are released
+static const float streamMargin = 0.5f;
+
+TileMap::~TileMap()
+{
+    Unload();
+}
+
+bool TileMap::ReadMap(const char* path, TileMapData& map)
+{
+    MemTagScope memTag(MEMTAG_TILEMAP);
+    std::string error;
+    std::string csvPath = std::string(path, strlen(path) - strlen(GetFileExtension(path))) + ".csv";
+    if (csvPath != path) {
+        if (ReadTileMapBinary(path, map, error)) {
+            return true;
+        }
+        TraceLog(LOG_INFO, "TILEMAP: %s, trying %s", error.c_str(), csvPath.c_str());
+    }
+    if (!ReadTileMapCsv(csvPath.c_str(), 32, map, error)) {
+        TraceLog(LOG_ERROR, "TILEMAP: Failed to load map: %s", error.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TileMap::Load(const char* path)
+{
+    TileMapData map;
+    if (!ReadMap(path, map)) {
+        return false;
+    }
+    Replace(map);
+    return true;
+}
+
+void TileMap::Replace(TileMapData& map)
+{
+    MemTagScope memTag(MEMTAG_TILEMAP);
+    // A recorded frame may still draw the old chunks, they are released by Update
+    for (Chunk& chunk : chunks) {
+        if (chunk.loaded) {
+            retiredChunks.push_back(RetiredChunk{chunk.target, renderReleaseDelayFrames});
+            chunk.loaded = false;
+        }
+    }
+    std::swap(data, map);
+
+    chunkColumns = (data.width + chunkTiles - 1) / chunkTiles;
+    chunkRows = (data.height + chunkTiles - 1) / chunkTiles;
+    chunks.assign(chunkColumns * chunkRows, Chunk());
+    TraceLog(LOG_INFO, "TILEMAP: Loaded %dx%d tiles in %dx%d chunks", data.width, data.height, chunkColumns, chunkRows);
+}
+
+void TileMap::Reload(TileMapData& map)
+{
+    if (map.width != data.width || map.height != data.height || map.tileSize != data.tileSize) {
+        Replace(map);
+        return;
+    }
+
+    int changed = 0;
+    for (int y = 0; y < data.height; y++) {
+        for (int x = 0; x < data.width; x++) {
+            int tile = map.tiles[y * data.width + x];
+            if (tile != GetTile(x, y)) {
+                SetTile(x, y, tile);
+                changed++;
+            }
+        }
+    }
+    TraceLog(LOG_INFO, "TILEMAP: %d tiles changed", changed);
+}
+
+void TileMap::Unload()
+{
+    for (Chunk& chunk : chunks) {
+        ReleaseChunk(chunk);
+    }
+    chunks.clear();
+    chunkColumns = 0;
+    chunkRows = 0;
+    ReleaseRetiredChunks(true);
+}
+
+int TileMap::GetTile(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= data.width || y >= data.height) return -1;
+    return data.tiles[y * data.width + x];
+}
+
+void TileMap::SetTile(int x, int y, int tile)
+{
+    if (x < 0 || y < 0 || x >= data.width || y >= data.height) return;
+    unsigned char& current = data.tiles[y * data.width + x];
+    if (current == tile) return;
+    current = (unsigned char)tile;
+    chunks[(y / chunkTiles) * chunkColumns + x / chunkTiles].dirty = true;
+}
+
+bool TileMap::IsSolid(int x, int y) const
+{
+    int tile = GetTile(x, y);
+    return tile < 0 || tile == TILE_WATER || tile == TILE_STONE;
+}
+
+int TileMap::GetLoadedChunkCount() const
+{
+    int count = 0;
+    for (const Chunk& chunk : chunks) {
+        if (chunk.loaded) count++;
+    }
+    return count;
+}
+
+Rectangle TileMap::ChunkBounds(int chunkX, int chunkY) const
+{
+    float chunkSize = (float)(chunkTiles * data.tileSize);
+    return {chunkX * chunkSize, chunkY * chunkSize, chunkSize, chunkSize};
+}
+
+void TileMap::BuildChunk(int chunkX, int chunkY)
+{
+    Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+    if (!chunk.loaded) {
+        chunk.target = LoadRenderTexture(chunkTiles * data.tileSize, chunkTiles * data.tileSize);
+        chunk.loaded = true;
+        MemTrackGpu(MEMTAG_TILEMAP, MemRenderTextureBytes(chunk.target));
+    }
+
+    BeginTextureMode(chunk.target);
+    ClearBackground(BLANK);
+    int startX = chunkX * chunkTiles;
+    int startY = chunkY * chunkTiles;
+    for (int y = 0; y < chunkTiles; y++) {
+        for (int x = 0; x < chunkTiles; x++) {
+            int tile = GetTile(startX + x, startY + y);
+            if (tile < 0) continue;
+            Color color = tileColors[tile < TILE_TYPE_COUNT ? tile : TILE_STONE];
+            // Slight checkerboard so individual tiles stay readable
+            if (((startX + x) + (startY + y)) % 2 == 0) {
+                color.r = (unsigned char)(color.r * 0.94f);
+                color.g = (unsigned char)(color.g * 0.94f);
+                color.b = (unsigned char)(color.b * 0.94f);
+            }
+            DrawRectangle(x * data.tileSize, y * data.tileSize, data.tileSize, data.tileSize, color);
+        }
+    }
+    EndTextureMode();
+    chunk.dirty = false;
+}
+
+void TileMap::ReleaseChunk(Chunk& chunk)
+{
+    if (chunk.loaded) {
+        MemTrackGpu(MEMTAG_TILEMAP, -MemRenderTextureBytes(chunk.target));
+        UnloadRenderTexture(chunk.target);
+        chunk.target = RenderTexture2D{};
+        chunk.loaded = false;
+    }
+    chunk.dirty = true;
+}
+
+void TileMap::ReleaseRetiredChunks(bool all)
+{
+    int kept = 0;
+    for (RetiredChunk& retired : retiredChunks) {
+        if (!all && retired.framesLeft-- > 0) {
+            retiredChunks[kept++] = retired;
+            continue;
+        }
+        MemTrackGpu(MEMTAG_TILEMAP, -MemRenderTextureBytes(retired.target));
+        UnloadRenderTexture(retired.target);
+    }
+    retiredChunks.resize(kept);
+}
+
+void TileMap::Update(Rectangle view)
+{
+    ReleaseRetiredChunks(false);
+    if (chunks.empty()) return;
+
+    float chunkSize = (float)(chunkTiles * data.tileSize);
+    Rectangle prefetch = {view.x - chunkSize * streamMargin, view.y - chunkSize * streamMargin,
+        view.width + chunkSize * streamMargin * 2, view.height + chunkSize * streamMargin * 2};
+    Rectangle keep = {view.x - chunkSize * streamMargin * 2, view.y - chunkSize * streamMargin * 2,
+        view.width + chunkSize * streamMargin * 4, view.height + chunkSize * streamMargin * 4};
+
+    int builds = 0;
+    for (int chunkY = 0; chunkY < chunkRows; chunkY++) {
+        for (int chunkX = 0; chunkX < chunkColumns; chunkX++) {
+            Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+            Rectangle bounds = ChunkBounds(chunkX, chunkY);
+
+            if (!CheckCollisionRecs(bounds, keep)) {
+                if (chunk.loaded && ++chunk.framesOutOfRange > renderReleaseDelayFrames) {
+                    ReleaseChunk(chunk);
+                }
+                continue;
+            }
+
+            chunk.framesOutOfRange = 0;
+            if (chunk.dirty) {
+                // Visible chunks are always built, prefetched ones are spread over frames
+                bool visible = CheckCollisionRecs(bounds, view);
+                if (visible || (builds < maxChunkBuildsPerFrame && CheckCollisionRecs(bounds, prefetch))) {
+                    BuildChunk(chunkX, chunkY);
+                    if (!visible) builds++;
+                }
+            }
+        }
+    }
+}
+
+void TileMap::Draw(RenderQueue& queue, Rectangle view) const
+{
+    for (int chunkY = 0; chunkY < chunkRows; chunkY++) {
+        for (int chunkX = 0; chunkX < chunkColumns; chunkX++) {
+            const Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+            Rectangle bounds = ChunkBounds(chunkX, chunkY);
+            if (!chunk.loaded || !CheckCollisionRecs(bounds, view)) continue;
+
+            // Render textures are stored upside down
+            Rectangle source = {0, 0, (float)chunk.target.texture.width, (float)-chunk.target.texture.height};
+            queue.AddTexture(LAYER_TILES, chunk.target.texture, source, bounds, WHITE);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+#include "tilemapformat.h"
+#include "renderqueue.h"
+
+// Tile map drawn from cached per-chunk render textures. A chunk is rendered
+// once when it comes near the camera, re-rendered only when one of its tiles
+// changes, and released again once the camera has moved away from it.
+class TileMap
+{
+public:
+    ~TileMap();
+
+    // Reads path, or the .csv next to it if the binary map is missing. path may
+    // also be the .csv itself. Doesn't touch GL, so it may run on any thread.
+    static bool ReadMap(const char* path, TileMapData& map);
+
+    bool Load(const char* path);
+    // Takes over map, marking only the chunks with changed tiles for rebuilding
+    // when the size stayed the same
+    void Reload(TileMapData& map);
+    void Unload();
+
+    int GetTile(int x, int y) const;
+    void SetTile(int x, int y, int tile);
+    bool IsSolid(int x, int y) const;
+
+    // Builds chunks around view and releases far away ones, call once per frame outside of any texture mode
+    void Update(Rectangle view);
+    void Draw(RenderQueue& queue, Rectangle view) const;
+
+    int GetWidth() const { return data.width; }
+    int GetHeight() const { return data.height; }
+    int GetTileSize() const { return data.tileSize; }
+    int GetLoadedChunkCount() const;
+
+    static const int chunkTiles = 16;       // Chunk width and height in tiles
+    int maxChunkBuildsPerFrame = 2;         // Chunks outside the view are built at most this many per frame
+
+private:
+    struct Chunk
+    {
+        RenderTexture2D target = {};
+        bool loaded = false;
+        bool dirty = true;
+        int framesOutOfRange = 0;
+    };
+
+    // Chunks of a replaced map, kept until no recorded frame can draw them
+    struct RetiredChunk
+    {
+        RenderTexture2D target;
+        int framesLeft;
+    };
+
+    void Replace(TileMapData& map);
+    Rectangle ChunkBounds(int chunkX, int chunkY) const;
+    void BuildChunk(int chunkX, int chunkY);
+    void ReleaseChunk(Chunk& chunk);
+    void ReleaseRetiredChunks(bool all);
+
+    TileMapData data;
+    std::vector<Chunk> chunks;
+    std::vector<RetiredChunk> retiredChunks;
+    int chunkColumns = 0;
+    int chunkRows = 0;
+};
@@ -0,0 +1,166 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "tilemapformat.h"
+
+static const char tileMapMagic[4] = {'T', 'M', 'A', 'P'};
+static const int tileMapVersion = 1;
+
+static bool ReadWholeFile(const char* path, std::vector<unsigned char>& bytes)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    bytes.resize(size > 0 ? size : 0);
+    size_t read = bytes.empty() ? 0 : fread(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+    return read == bytes.size();
+}
+
+static void PutU16(std::vector<unsigned char>& out, int value)
+{
+    out.push_back((unsigned char)(value & 0xFF));
+    out.push_back((unsigned char)((value >> 8) & 0xFF));
+}
+
+static int GetU16(const unsigned char* bytes)
+{
+    return bytes[0] | (bytes[1] << 8);
+}
+
+bool ParseTileMapCsv(const std::string& text, int tileSize, TileMapData& map, std::string& error)
+{
+    map = TileMapData();
+    map.tileSize = tileSize;
+
+    size_t lineStart = 0;
+    int lineNumber = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = text.size();
+        std::string line = text.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        lineNumber++;
+
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        int columns = 0;
+        const char* cursor = line.c_str();
+        while (*cursor) {
+            char* end = nullptr;
+            long tile = strtol(cursor, &end, 10);
+            if (end == cursor || tile < 0 || tile > 255) {
+                error = "line " + std::to_string(lineNumber) + ": expected a tile id from 0 to 255";
+                return false;
+            }
+            map.tiles.push_back((unsigned char)tile);
+            columns++;
+            cursor = end;
+            while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') cursor++;
+            if (*cursor == ',') cursor++;
+        }
+
+        if (map.height == 0) {
+            map.width = columns;
+        } else if (columns != map.width) {
+            error = "line " + std::to_string(lineNumber) + ": has " + std::to_string(columns) +
+                " columns, expected " + std::to_string(map.width);
+            return false;
+        }
+        map.height++;
+    }
+
+    if (map.width == 0 || map.height == 0) {
+        error = "map is empty";
+        return false;
+    }
+    if (map.width > 0xFFFF || map.height > 0xFFFF) {
+        error = "map is too large";
+        return false;
+    }
+    return true;
+}
+
+bool ReadTileMapCsv(const char* path, int tileSize, TileMapData& map, std::string& error)
+{
+    std::vector<unsigned char> bytes;
+    if (!ReadWholeFile(path, bytes)) {
+        error = std::string("cannot read ") + path;
+        return false;
+    }
+    return ParseTileMapCsv(std::string(bytes.begin(), bytes.end()), tileSize, map, error);
+}
+
+bool ReadTileMapBinary(const char* path, TileMapData& map, std::string& error)
+{
+    std::vector<unsigned char> bytes;
+    if (!ReadWholeFile(path, bytes)) {
+        error = std::string("cannot read ") + path;
+        return false;
+    }
+
+    const size_t headerSize = 12;
+    if (bytes.size() < headerSize || memcmp(bytes.data(), tileMapMagic, 4) != 0) {
+        error = std::string(path) + " is not a tile map";
+        return false;
+    }
+    if (GetU16(&bytes[4]) != tileMapVersion) {
+        error = std::string(path) + " has an unsupported version";
+        return false;
+    }
+
+    map = TileMapData();
+    map.tileSize = GetU16(&bytes[6]);
+    map.width = GetU16(&bytes[8]);
+    map.height = GetU16(&bytes[10]);
+    // The chunk math divides by the tile size and an empty map has nothing to draw
+    if (map.tileSize <= 0 || map.width <= 0 || map.height <= 0) {
+        error = std::string(path) + " is not a valid tile map";
+        return false;
+    }
+    size_t tileCount = (size_t)map.width * map.height;
+    map.tiles.reserve(tileCount);
+
+    for (size_t i = headerSize; i + 1 < bytes.size() && map.tiles.size() < tileCount; i += 2) {
+        map.tiles.insert(map.tiles.end(), bytes[i], bytes[i + 1]);
+    }
+    if (map.tiles.size() != tileCount) {
+        error = std::string(path) + " is truncated or corrupt";
+        return false;
+    }
+    return true;
+}
+
+bool WriteTileMapBinary(const char* path, const TileMapData& map, std::string& error)
+{
+    std::vector<unsigned char> out(tileMapMagic, tileMapMagic + 4);
+    PutU16(out, tileMapVersion);
+    PutU16(out, map.tileSize);
+    PutU16(out, map.width);
+    PutU16(out, map.height);
+
+    for (size_t i = 0; i < map.tiles.size(); ) {
+        unsigned char tile = map.tiles[i];
+        size_t run = 1;
+        while (i + run < map.tiles.size() && map.tiles[i + run] == tile && run < 255) run++;
+        out.push_back((unsigned char)run);
+        out.push_back(tile);
+        i += run;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        error = std::string("cannot write ") + path;
+        return false;
+    }
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    fclose(file);
+    if (!ok) {
+        error = std::string("failed writing ") + path;
+    }
+    return ok;
+}
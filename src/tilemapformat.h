@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Tile map data and its on-disk formats. Kept free of raylib so the
+// tilemap_convert build tool can use it without a window or GPU.
+//
+// Binary format (.map), little endian:
+//   char[4]  magic "TMAP"
+//   uint16   version (1)
+//   uint16   tile size in pixels
+//   uint16   width in tiles
+//   uint16   height in tiles
+//   then run-length encoded tiles in row order as (uint8 count, uint8 tile) pairs
+//
+// Text format (.csv): one row of comma separated tile ids per line.
+struct TileMapData
+{
+    int width = 0;
+    int height = 0;
+    int tileSize = 32;
+    std::vector<unsigned char> tiles;
+};
+
+bool ParseTileMapCsv(const std::string& text, int tileSize, TileMapData& map, std::string& error);
+bool ReadTileMapCsv(const char* path, int tileSize, TileMapData& map, std::string& error);
+bool ReadTileMapBinary(const char* path, TileMapData& map, std::string& error);
+bool WriteTileMapBinary(const char* path, const TileMapData& map, std::string& error);
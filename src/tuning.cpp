@@ -0,0 +1,98 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include "raylib.h"
+#include "tuning.h"
+
+static std::string Trim(const std::string& text)
+{
+    size_t start = text.find_first_not_of(" \t\r");
+    if (start == std::string::npos) return std::string();
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(start, end - start + 1);
+}
+
+bool TuningFile::Load(const char* path)
+{
+    char* text = LoadFileText(path);
+    if (text == NULL) {
+        TraceLog(LOG_WARNING, "TUNING: Failed to load tuning file: %s", path);
+        return false;
+    }
+
+    values.clear();
+    std::string content = text;
+    UnloadFileText(text);
+
+    size_t lineStart = 0;
+    int lineNumber = 0;
+    while (lineStart < content.size()) {
+        size_t lineEnd = content.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = content.size();
+        std::string line = Trim(content.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+        lineNumber++;
+
+        if (line.empty() || line[0] == '#') continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            TraceLog(LOG_WARNING, "TUNING: %s:%d: expected name = value", path, lineNumber);
+            continue;
+        }
+        values.push_back(std::make_pair(Trim(line.substr(0, equals)), Trim(line.substr(equals + 1))));
+    }
+    return true;
+}
+
+const std::string* TuningFile::Find(const char* name) const
+{
+    for (const auto& entry : values) {
+        if (entry.first == name) return &entry.second;
+    }
+    return nullptr;
+}
+
+bool TuningFile::GetFloat(const char* name, float& value) const
+{
+    const std::string* text = Find(name);
+    if (text == nullptr) return false;
+    char* end = nullptr;
+    float parsed = strtof(text->c_str(), &end);
+    if (end == text->c_str()) {
+        TraceLog(LOG_WARNING, "TUNING: %s is not a number: %s", name, text->c_str());
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool TuningFile::GetInt(const char* name, int& value) const
+{
+    float parsed;
+    if (!GetFloat(name, parsed)) return false;
+    value = (int)parsed;
+    return true;
+}
+
+bool TuningFile::GetColor(const char* name, Color& value) const
+{
+    const std::string* text = Find(name);
+    if (text == nullptr) return false;
+    int r, g, b, a = 255;
+    if (sscanf(text->c_str(), "%d %d %d %d", &r, &g, &b, &a) < 3) {
+        TraceLog(LOG_WARNING, "TUNING: %s is not a color: %s", name, text->c_str());
+        return false;
+    }
+    value = Color{(unsigned char)r, (unsigned char)g, (unsigned char)b, (unsigned char)a};
+    return true;
+}
+
+bool TuningFile::GetString(const char* name, std::string& value) const
+{
+    const std::string* text = Find(name);
+    if (text == nullptr) return false;
+    value = *text;
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "raylib.h"
+
+// Key/value tuning parameters read from a text file, one "name = value" per line.
+// Colors are written as four 0-255 components, e.g. "ballColor = 230 41 55 255".
+class TuningFile
+{
+public:
+    bool Load(const char* path);
+
+    bool GetFloat(const char* name, float& value) const;
+    bool GetInt(const char* name, int& value) const;
+    bool GetColor(const char* name, Color& value) const;
+    bool GetString(const char* name, std::string& value) const;
+
+private:
+    const std::string* Find(const char* name) const;
+
+    std::vector<std::pair<std::string, std::string>> values;
+};
@@ -0,0 +1,349 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "atlasformat.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include "stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+// Packs images into atlas pages with a MaxRects packer and writes the sprite
+// index loaded by SpriteAtlas. Pages are written next to the index as
+// <index name>_<page>.png. With --pages it fails unless the images pack into
+// exactly that many pages, the build lists the page files it expects.
+// Usage: atlas_pack [--pages <count>] <output.atlas> <max page size> <image.png>...
+
+// Each sprite's border pixels are repeated once around it, so bilinear
+// filtering at the edge of a region never samples a neighbouring sprite
+static const int extrude = 1;
+static const int minPageSize = 64;
+
+struct PackRect
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+struct SourceImage
+{
+    std::string name;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;  // RGBA
+};
+
+// MaxRects bin with the best short side fit heuristic: every free area is
+// kept as a maximal rectangle, a sprite goes where it leaves the smallest
+// leftover on its shorter side, and the free list is split and pruned after
+// each placement.
+class MaxRectsBin
+{
+public:
+    MaxRectsBin(int width, int height)
+    {
+        PackRect all;
+        all.width = width;
+        all.height = height;
+        freeRects.push_back(all);
+    }
+
+    bool Insert(int width, int height, PackRect& placed)
+    {
+        int bestShortSide = 0x7FFFFFFF;
+        int bestLongSide = 0x7FFFFFFF;
+        bool found = false;
+        for (const PackRect& free : freeRects) {
+            if (free.width < width || free.height < height) continue;
+            int leftoverX = free.width - width;
+            int leftoverY = free.height - height;
+            int shortSide = std::min(leftoverX, leftoverY);
+            int longSide = std::max(leftoverX, leftoverY);
+            if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+                placed.x = free.x;
+                placed.y = free.y;
+                placed.width = width;
+                placed.height = height;
+                bestShortSide = shortSide;
+                bestLongSide = longSide;
+                found = true;
+            }
+        }
+        if (!found) return false;
+
+        std::vector<PackRect> split;
+        for (const PackRect& free : freeRects) {
+            SplitFreeRect(free, placed, split);
+        }
+        freeRects.swap(split);
+        PruneFreeRects();
+        return true;
+    }
+
+private:
+    static bool Intersects(const PackRect& a, const PackRect& b)
+    {
+        return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    static bool Contains(const PackRect& outer, const PackRect& inner)
+    {
+        return inner.x >= outer.x && inner.y >= outer.y &&
+            inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+    }
+
+    // Replaces free by up to four maximal rectangles around used
+    static void SplitFreeRect(const PackRect& free, const PackRect& used, std::vector<PackRect>& out)
+    {
+        if (!Intersects(free, used)) {
+            out.push_back(free);
+            return;
+        }
+        if (used.x > free.x) {
+            PackRect left = free;
+            left.width = used.x - free.x;
+            out.push_back(left);
+        }
+        if (used.x + used.width < free.x + free.width) {
+            PackRect right = free;
+            right.x = used.x + used.width;
+            right.width = free.x + free.width - right.x;
+            out.push_back(right);
+        }
+        if (used.y > free.y) {
+            PackRect top = free;
+            top.height = used.y - free.y;
+            out.push_back(top);
+        }
+        if (used.y + used.height < free.y + free.height) {
+            PackRect bottom = free;
+            bottom.y = used.y + used.height;
+            bottom.height = free.y + free.height - bottom.y;
+            out.push_back(bottom);
+        }
+    }
+
+    void PruneFreeRects()
+    {
+        for (size_t i = 0; i < freeRects.size(); i++) {
+            for (size_t j = i + 1; j < freeRects.size(); ) {
+                if (Contains(freeRects[j], freeRects[i])) {
+                    freeRects.erase(freeRects.begin() + i);
+                    i--;
+                    break;
+                }
+                if (Contains(freeRects[i], freeRects[j])) {
+                    freeRects.erase(freeRects.begin() + j);
+                } else {
+                    j++;
+                }
+            }
+        }
+    }
+
+    std::vector<PackRect> freeRects;
+};
+
+struct Page
+{
+    int width = 0;
+    int height = 0;
+    std::vector<int> images;        // Indices into the image list
+    std::vector<PackRect> slots;    // Placement of each image including its extruded border
+};
+
+// Packs as many of pending as fit into a width x height page, in order
+static Page PackPage(const std::vector<SourceImage>& images, const std::vector<int>& pending, int width, int height)
+{
+    Page page;
+    page.width = width;
+    page.height = height;
+    MaxRectsBin bin(width, height);
+    for (int image : pending) {
+        PackRect slot;
+        if (bin.Insert(images[image].width + extrude * 2, images[image].height + extrude * 2, slot)) {
+            page.images.push_back(image);
+            page.slots.push_back(slot);
+        }
+    }
+    return page;
+}
+
+// Smallest power of two page that takes everything pending, or a full size
+// page with as much as fits when nothing smaller does. Power of two sizes
+// because WebGL 1 can't sample non power of two textures with repeat wrapping.
+static Page PackNextPage(const std::vector<SourceImage>& images, const std::vector<int>& pending, int maxPageSize)
+{
+    for (int height = minPageSize; height <= maxPageSize; height *= 2) {
+        for (int width = height; width <= maxPageSize && width <= height * 2; width *= 2) {
+            Page page = PackPage(images, pending, width, height);
+            if (page.images.size() == pending.size()) {
+                return page;
+            }
+        }
+    }
+    return PackPage(images, pending, maxPageSize, maxPageSize);
+}
+
+static void BlitExtruded(const SourceImage& image, const PackRect& slot, std::vector<unsigned char>& page, int pageWidth)
+{
+    for (int y = 0; y < slot.height; y++) {
+        int sourceY = std::min(std::max(y - extrude, 0), image.height - 1);
+        for (int x = 0; x < slot.width; x++) {
+            int sourceX = std::min(std::max(x - extrude, 0), image.width - 1);
+            const unsigned char* source = &image.pixels[(sourceY * image.width + sourceX) * 4];
+            unsigned char* target = &page[((slot.y + y) * pageWidth + slot.x + x) * 4];
+            memcpy(target, source, 4);
+        }
+    }
+}
+
+static std::string BaseName(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return (dot == std::string::npos) ? name : name.substr(0, dot);
+}
+
+int main(int argc, char** argv)
+{
+    int expectedPages = 0;
+    if (argc > 2 && strcmp(argv[1], "--pages") == 0) {
+        expectedPages = atoi(argv[2]);
+        if (expectedPages <= 0) {
+            fprintf(stderr, "atlas_pack: invalid page count %s\n", argv[2]);
+            return 2;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 3) {
+        fprintf(stderr, "Usage: atlas_pack [--pages <count>] <output.atlas> <max page size> <image.png>...\n");
+        return 2;
+    }
+
+    std::string indexPath = argv[1];
+    int maxPageSize = atoi(argv[2]);
+    if (maxPageSize < minPageSize || maxPageSize > 0xFFFF) {
+        fprintf(stderr, "atlas_pack: invalid page size %s\n", argv[2]);
+        return 2;
+    }
+
+    std::vector<SourceImage> images;
+    // Opaque white block for drawing shapes from the atlas, see SpriteAtlas::UseForShapes
+    SourceImage white;
+    white.name = atlasWhiteSprite;
+    white.width = 4;
+    white.height = 4;
+    white.pixels.assign(4 * 4 * 4, 255);
+    images.push_back(white);
+
+    for (int i = 3; i < argc; i++) {
+        SourceImage image;
+        image.name = BaseName(argv[i]);
+        int channels = 0;
+        unsigned char* pixels = stbi_load(argv[i], &image.width, &image.height, &channels, 4);
+        if (pixels == nullptr) {
+            fprintf(stderr, "atlas_pack: %s: %s\n", argv[i], stbi_failure_reason());
+            return 1;
+        }
+        image.pixels.assign(pixels, pixels + image.width * image.height * 4);
+        stbi_image_free(pixels);
+
+        if (image.name.empty() || image.name.size() > 255) {
+            fprintf(stderr, "atlas_pack: %s: sprite names must be 1 to 255 characters\n", argv[i]);
+            return 1;
+        }
+        if (image.width + extrude * 2 > maxPageSize || image.height + extrude * 2 > maxPageSize) {
+            fprintf(stderr, "atlas_pack: %s: %dx%d does not fit a %d page\n", argv[i], image.width, image.height, maxPageSize);
+            return 1;
+        }
+        for (const SourceImage& other : images) {
+            if (other.name == image.name) {
+                fprintf(stderr, "atlas_pack: %s: duplicate sprite name '%s'\n", argv[i], image.name.c_str());
+                return 1;
+            }
+        }
+        images.push_back(image);
+    }
+
+    // Large sprites first, MaxRects fills the gaps they leave with the small ones
+    std::vector<int> pending;
+    for (int i = 0; i < (int)images.size(); i++) pending.push_back(i);
+    std::sort(pending.begin(), pending.end(), [&images](int a, int b) {
+        int sideA = std::max(images[a].width, images[a].height);
+        int sideB = std::max(images[b].width, images[b].height);
+        if (sideA != sideB) return sideA > sideB;
+        return images[a].width * images[a].height > images[b].width * images[b].height;
+    });
+
+    std::vector<Page> pages;
+    while (!pending.empty()) {
+        Page page = PackNextPage(images, pending, maxPageSize);
+        std::vector<int> remaining;
+        for (int image : pending) {
+            if (std::find(page.images.begin(), page.images.end(), image) == page.images.end()) {
+                remaining.push_back(image);
+            }
+        }
+        pending.swap(remaining);
+        pages.push_back(page);
+    }
+    if (expectedPages > 0 && (int)pages.size() != expectedPages) {
+        fprintf(stderr, "atlas_pack: the images pack into %d pages, not %d (set ATLAS_PAGES to %d)\n",
+            (int)pages.size(), expectedPages, (int)pages.size());
+        return 1;
+    }
+
+    std::string pageBase = indexPath.substr(0, indexPath.find_last_of('.'));
+    AtlasIndex index;
+    long long spriteArea = 0;
+    long long pageArea = 0;
+    for (int p = 0; p < (int)pages.size(); p++) {
+        const Page& page = pages[p];
+        std::vector<unsigned char> pixels((size_t)page.width * page.height * 4, 0);
+        long long used = 0;
+        for (size_t i = 0; i < page.images.size(); i++) {
+            const SourceImage& image = images[page.images[i]];
+            const PackRect& slot = page.slots[i];
+            BlitExtruded(image, slot, pixels, page.width);
+            used += (long long)image.width * image.height;
+
+            AtlasSpriteEntry sprite;
+            sprite.name = image.name;
+            sprite.page = p;
+            sprite.x = slot.x + extrude;
+            sprite.y = slot.y + extrude;
+            sprite.width = image.width;
+            sprite.height = image.height;
+            index.sprites.push_back(sprite);
+        }
+
+        std::string pagePath = pageBase + "_" + std::to_string(p) + ".png";
+        if (!stbi_write_png(pagePath.c_str(), page.width, page.height, 4, pixels.data(), page.width * 4)) {
+            fprintf(stderr, "atlas_pack: cannot write %s\n", pagePath.c_str());
+            return 1;
+        }
+        index.pages.push_back(pagePath.substr(pagePath.find_last_of("/\\") + 1));
+        printf("atlas_pack: page %d %dx%d, %d sprites, fill %.1f%%\n", p, page.width, page.height,
+            (int)page.images.size(), 100.0 * used / ((double)page.width * page.height));
+        spriteArea += used;
+        pageArea += (long long)page.width * page.height;
+    }
+
+    std::string error;
+    if (!WriteAtlasIndex(indexPath.c_str(), index, error)) {
+        fprintf(stderr, "atlas_pack: %s\n", error.c_str());
+        return 1;
+    }
+    printf("atlas_pack: %s, %d sprites in %d pages, fill %.1f%%\n", indexPath.c_str(), (int)index.sprites.size(),
+        (int)pages.size(), pageArea > 0 ? 100.0 * spriteArea / pageArea : 0.0);
+    return 0;
+}
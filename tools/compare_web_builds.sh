@@ -0,0 +1,109 @@
+#!/bin/bash
+# Compares the web build of build_web.sh (ASYNCIFY, growing memory, no
+# optimization flags) with the CMake web target (-O3, LTO, WASM SIMD, fixed
+# memory). Both are linked with emcc directly using the flags of their build,
+# then run headless under node for a fixed number of frames with
+# tools/web_node_shim.js standing in for the browser (no rendering, no audio
+# device). Prints the output sizes and the game's own "WEB:" log lines:
+# startup to first frame, average frame cost and the sbrk heap high-water
+# mark, which WEB_INITIAL_MEMORY in CMakeLists.txt is sized from.
+#
+# Needs emcc (source emsdk_env.sh first) and node. The average frame cost is
+# logged every 600 frames, so frames should be a multiple of 600.
+#
+# Usage: tools/compare_web_builds.sh [raylib source dir] [frames]
+set -e
+RAYLIB_PATH=${1:-C:/raylib/raylib}
+FRAMES=${2:-1200}
+# The CMake variant runs in a large arena so a too small WEB_INITIAL_MEMORY cannot abort the measurement
+MEASURE_MEMORY=134217728
+HEADROOM_PERCENT=25
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT="$ROOT/build-web-compare"
+for tool in emcc node; do
+    if ! command -v $tool > /dev/null; then
+        echo "$tool not found" >&2
+        exit 1
+    fi
+done
+
+rm -rf "$OUT"
+mkdir -p "$OUT/build_web" "$OUT/cmake" "$OUT/data"
+
+# The CMake build preloads data/ without the sprite sources, plus the converted level and the packed atlas
+echo "Converting level and packing atlas"
+cp -r "$ROOT/data/." "$OUT/data"
+rm -rf "$OUT/data/sprites"
+emcc -O2 -sNODERAWFS=1 -I"$ROOT/src" "$ROOT/tools/tilemap_convert.cpp" "$ROOT/src/tilemapformat.cpp" -o "$OUT/tilemap_convert.js"
+emcc -O2 -sNODERAWFS=1 -I"$ROOT/src" -I"$RAYLIB_PATH/src/external" "$ROOT/tools/atlas_pack.cpp" "$ROOT/src/atlasformat.cpp" -o "$OUT/atlas_pack.js"
+node "$OUT/tilemap_convert.js" "$ROOT/data/level.csv" "$OUT/data/level.map" 32 > /dev/null
+node "$OUT/atlas_pack.js" "$OUT/data/sprites.atlas" 1024 "$ROOT"/data/sprites/*.png > /dev/null
+
+COMMON=(
+    "$ROOT"/src/*.cpp
+    -I"$RAYLIB_PATH/src"
+    "$ROOT/libraylib.web.a"
+    -DPLATFORM_WEB
+    -DEMSCRIPTEN_BUILD
+    -sUSE_GLFW=3
+    -sFORCE_FILESYSTEM=1
+    "-sEXPORTED_FUNCTIONS=['_main']"
+    "-sEXPORTED_RUNTIME_METHODS=['ccall','cwrap']"
+    -sENVIRONMENT=web,node
+    --pre-js "$ROOT/tools/web_node_shim.js"
+)
+
+echo "Building build_web.sh variant"
+emcc "${COMMON[@]}" \
+    -sASYNCIFY \
+    -sTOTAL_MEMORY=16777216 \
+    -sALLOW_MEMORY_GROWTH=1 \
+    -sSTACK_SIZE=2097152 \
+    --preload-file "$ROOT/data@/data" \
+    -o "$OUT/build_web/index.js"
+
+echo "Building CMake variant"
+emcc "${COMMON[@]}" \
+    -O3 -flto -msimd128 \
+    -sINITIAL_MEMORY=$MEASURE_MEMORY \
+    -sALLOW_MEMORY_GROWTH=0 \
+    -sSTACK_SIZE=1048576 \
+    --preload-file "$OUT/data@/data" \
+    -o "$OUT/cmake/index.js"
+
+for variant in build_web cmake; do
+    echo "Running $variant for $FRAMES frames"
+    if ! (cd "$OUT/$variant" && WEB_FRAMES=$FRAMES node index.js > run.log 2>&1) || ! grep -q "WEB: ran" "$OUT/$variant/run.log"; then
+        echo "$variant did not finish, see $OUT/$variant/run.log:" >&2
+        tail -20 "$OUT/$variant/run.log" >&2
+        exit 1
+    fi
+done
+
+# Number after the last line containing the text, "-" when there is none
+logged() {
+    grep "$2" "$OUT/$1/run.log" | tail -1 | sed -E "s/.*$2 ([0-9.]+).*/\1/" | grep . || echo "-"
+}
+size() {
+    if [ -f "$OUT/$1/$2" ]; then wc -c < "$OUT/$1/$2" | tr -d ' '; else echo "-"; fi
+}
+
+echo
+printf "%-32s %14s %14s\n" "" "build_web.sh" "cmake"
+for f in index.wasm index.js index.data; do
+    printf "%-32s %14s %14s\n" "$f (bytes)" "$(size build_web $f)" "$(size cmake $f)"
+done
+printf "%-32s %14s %14s\n" "node start to first frame (ms)" "$(logged build_web 'node start to first frame')" "$(logged cmake 'node start to first frame')"
+printf "%-32s %14s %14s\n" "main to first frame (ms)" "$(logged build_web 'startup to first frame')" "$(logged cmake 'startup to first frame')"
+printf "%-32s %14s %14s\n" "average frame cost (ms)" "$(logged build_web 'average frame cost')" "$(logged cmake 'average frame cost')"
+printf "%-32s %14s %14s\n" "heap high-water mark (MB)" "$(logged build_web 'heap high-water mark')" "$(logged cmake 'heap high-water mark')"
+
+HIGH_WATER=$(logged cmake 'heap high-water mark')
+if [ "$HIGH_WATER" != "-" ]; then
+    # High-water mark plus headroom, rounded up to whole MB (a multiple of the 64 KB wasm page)
+    MEMORY=$(awk -v mb="$HIGH_WATER" -v headroom="$HEADROOM_PERCENT" \
+        'BEGIN { m = mb * (100 + headroom) / 100; r = int(m); if (r < m) r++; printf "%d", r * 1048576 }')
+    echo
+    echo "WEB_INITIAL_MEMORY: $HIGH_WATER MB high-water mark plus $HEADROOM_PERCENT% headroom = $MEMORY bytes"
+fi
@@ -0,0 +1,34 @@
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include "tilemapformat.h"
+
+// Converts a text tile map to the binary .map format loaded by the game.
+// Usage: tilemap_convert <input.csv> <output.map> [tileSize]
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: tilemap_convert <input.csv> <output.map> [tileSize]\n");
+        return 2;
+    }
+
+    int tileSize = (argc > 3) ? atoi(argv[3]) : 32;
+    if (tileSize <= 0 || tileSize > 0xFFFF) {
+        fprintf(stderr, "tilemap_convert: invalid tile size %s\n", argv[3]);
+        return 2;
+    }
+
+    TileMapData map;
+    std::string error;
+    if (!ReadTileMapCsv(argv[1], tileSize, map, error)) {
+        fprintf(stderr, "tilemap_convert: %s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+    if (!WriteTileMapBinary(argv[2], map, error)) {
+        fprintf(stderr, "tilemap_convert: %s\n", error.c_str());
+        return 1;
+    }
+
+    printf("tilemap_convert: %s -> %s (%dx%d tiles, %dpx)\n", argv[1], argv[2], map.width, map.height, map.tileSize);
+    return 0;
+}
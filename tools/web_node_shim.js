@@ -0,0 +1,98 @@
+// Headless stand-in for the browser, linked with --pre-js by
+// tools/compare_web_builds.sh so the web build runs under node. Provides only
+// what raylib's GLFW, WebGL and input setup touch: the WebGL context accepts
+// every call and draws nothing, there is no audio device, and
+// requestAnimationFrame runs WEB_FRAMES frames back to back, then exits.
+if (typeof process === 'object' && typeof window === 'undefined') {
+    (function () {
+        var frames = parseInt(process.env.WEB_FRAMES || '1200', 10);
+        var shimStart = performance.now();
+        var frame = 0;
+        var noop = function () {};
+        var listeners = {addEventListener: noop, removeEventListener: noop};
+
+        var canvas = Object.assign({
+            id: 'canvas',
+            width: 300,
+            height: 150,
+            style: {setProperty: noop, removeProperty: noop},
+            parentNode: {},
+            getBoundingClientRect: function () {
+                return {left: 0, top: 0, x: 0, y: 0, right: canvas.width, bottom: canvas.height, width: canvas.width, height: canvas.height};
+            },
+            getContext: function (type) {
+                return (type === 'webgl' || type === 'experimental-webgl') ? gl : null;
+            }
+        }, listeners);
+        Object.defineProperty(canvas, 'clientWidth', {get: function () { return canvas.width; }});
+        Object.defineProperty(canvas, 'clientHeight', {get: function () { return canvas.height; }});
+
+        var parameters = {
+            0x1F00: 'node',                 // VENDOR
+            0x1F01: 'headless',             // RENDERER
+            0x1F02: 'WebGL 1.0',            // VERSION
+            0x8B8C: 'WebGL GLSL ES 1.0',    // SHADING_LANGUAGE_VERSION
+            0x0D33: 4096,                   // MAX_TEXTURE_SIZE
+            0x8869: 16,                     // MAX_VERTEX_ATTRIBS
+            0x86A3: []                      // COMPRESSED_TEXTURE_FORMATS
+        };
+        var context = {
+            canvas: canvas,
+            getContextAttributes: function () { return {alpha: false, depth: true, stencil: false, antialias: false}; },
+            getExtension: function () { return null; },
+            getSupportedExtensions: function () { return []; },
+            getParameter: function (name) { return (name in parameters) ? parameters[name] : 0; },
+            getShaderParameter: function () { return true; },
+            // LINK_STATUS and VALIDATE_STATUS succeed, there are no active uniforms or attributes
+            getProgramParameter: function (program, name) { return (name === 0x8B82 || name === 0x8B83) ? true : 0; },
+            getShaderInfoLog: function () { return ''; },
+            getProgramInfoLog: function () { return ''; },
+            getAttribLocation: function () { return 0; },
+            checkFramebufferStatus: function () { return 0x8CD5; },
+            getError: function () { return 0; },
+            isContextLost: function () { return false; }
+        };
+        Object.defineProperty(context, 'drawingBufferWidth', {get: function () { return canvas.width; }});
+        Object.defineProperty(context, 'drawingBufferHeight', {get: function () { return canvas.height; }});
+        // Any other call is accepted, create* returns a fresh object the GL library can name
+        var gl = new Proxy(context, {
+            get: function (target, name) {
+                if (name in target || typeof name !== 'string') return target[name];
+                return name.indexOf('create') === 0 ? function () { return {}; } : noop;
+            }
+        });
+
+        globalThis.window = globalThis;
+        Object.assign(globalThis, listeners);
+        globalThis.devicePixelRatio = 1;
+        globalThis.innerWidth = 1280;
+        globalThis.innerHeight = 720;
+        globalThis.screen = {width: 1920, height: 1080, availWidth: 1920, availHeight: 1080};
+        globalThis.matchMedia = function () { return Object.assign({matches: false}, listeners); };
+        globalThis.document = Object.assign({
+            title: '',
+            querySelector: function (selector) { return selector === '#canvas' ? canvas : null; },
+            getElementById: function (id) { return id === 'canvas' ? canvas : null; }
+        }, listeners);
+        Object.defineProperty(globalThis, 'navigator', {
+            value: {userAgent: 'node', platform: 'node', getGamepads: function () { return []; }},
+            configurable: true
+        });
+
+        globalThis.requestAnimationFrame = function (callback) {
+            if (frame === 0) {
+                console.log('WEB: node start to first frame ' + (performance.now() - shimStart).toFixed(1) + ' ms');
+            }
+            if (frame++ >= frames) {
+                console.log('WEB: ran ' + frames + ' frames');
+                process.exit(0);
+            }
+            setImmediate(function () { callback(performance.now()); });
+        };
+
+        Module['canvas'] = canvas;
+        // The browser's image and audio preload plugins need the DOM, the game decodes its data itself
+        Module['noImageDecoding'] = true;
+        Module['noAudioDecoding'] = true;
+    })();
+}